@@ -63,4 +63,13 @@ namespace ams::dmnt::cheat {
         FrozenAddressValue value;
     };
 
+    struct CheatVmMemoryStatistics {
+        u64 num_reads;
+        u64 num_writes;
+        u64 num_read_svcs;
+        u64 num_write_svcs;
+    };
+
+    static_assert(util::is_pod<CheatVmMemoryStatistics>::value && sizeof(CheatVmMemoryStatistics) == 0x20, "CheatVmMemoryStatistics definition!");
+
 }
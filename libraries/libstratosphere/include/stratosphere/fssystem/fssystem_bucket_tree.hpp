@@ -16,6 +16,7 @@
 #pragma once
 #include <vapours.hpp>
 #include <stratosphere/fs/fs_substorage.hpp>
+#include <stratosphere/os.hpp>
 
 namespace ams::fssystem {
 
@@ -75,6 +76,12 @@ namespace ams::fssystem {
                     constexpr bool CanDo() const { return this->read_size > 0; }
             };
 
+            struct CacheStatistics {
+                s64 hit_count;
+                s64 miss_count;
+            };
+            static_assert(util::is_pod<CacheStatistics>::value);
+
             using IAllocator = MemoryResource;
         private:
             class NodeBuffer {
@@ -149,6 +156,53 @@ namespace ams::fssystem {
                         return this->allocator;
                     }
             };
+
+            /* Keeps recently used, already verified L2 nodes and entry sets resident, so that lookups don't have to re-read them. */
+            class NodeCache {
+                NON_COPYABLE(NodeCache);
+                NON_MOVEABLE(NodeCache);
+                public:
+                    static constexpr s32 BlockCountMax = 4;
+                    static constexpr size_t CacheSizeMax = 64_KB;
+
+                    enum class BlockType : u8 {
+                        Node     = 0,
+                        EntrySet = 1,
+                    };
+                private:
+                    struct Block {
+                        char *buffer;
+                        s32 index;
+                        BlockType type;
+                        u32 last_used;
+                    };
+                private:
+                    os::Mutex mutex;
+                    Block blocks[BlockCountMax];
+                    s32 block_count;
+                    s32 block_count_max;
+                    u32 counter;
+                    s64 hit_count;
+                    s64 miss_count;
+                public:
+                    NodeCache() : mutex(false), blocks(), block_count(), block_count_max(), counter(), hit_count(), miss_count() { /* ... */ }
+
+                    void Initialize(size_t node_size);
+                    void Finalize(IAllocator *allocator, size_t node_size);
+
+                    void Invalidate();
+
+                    const char *Find(BlockType type, s32 index);
+                    void Insert(IAllocator *allocator, size_t node_size, BlockType type, s32 index, const char *buffer);
+
+                    void GetStatistics(CacheStatistics *out) const {
+                        out->hit_count  = this->hit_count;
+                        out->miss_count = this->miss_count;
+                    }
+
+                    void lock() { this->mutex.lock(); }
+                    void unlock() { this->mutex.unlock(); }
+            };
         private:
             static constexpr s32 GetEntryCount(size_t node_size, size_t entry_size) {
                 return static_cast<s32>((node_size - sizeof(NodeHeader)) / entry_size);
@@ -208,6 +262,7 @@ namespace ams::fssystem {
             mutable fs::SubStorage node_storage;
             mutable fs::SubStorage entry_storage;
             NodeBuffer node_l1;
+            mutable NodeCache node_cache;
             size_t node_size;
             size_t entry_size;
             s32 entry_count;
@@ -216,7 +271,7 @@ namespace ams::fssystem {
             s64 start_offset;
             s64 end_offset;
         public:
-            BucketTree() : node_storage(), entry_storage(), node_l1(), node_size(), entry_size(), entry_count(), offset_count(), entry_set_count(), start_offset(), end_offset() { /* ... */ }
+            BucketTree() : node_storage(), entry_storage(), node_l1(), node_cache(), node_size(), entry_size(), entry_count(), offset_count(), entry_set_count(), start_offset(), end_offset() { /* ... */ }
             ~BucketTree() { this->Finalize(); }
 
             Result Initialize(IAllocator *allocator, fs::SubStorage node_storage, fs::SubStorage entry_storage, size_t node_size, size_t entry_size, s32 entry_count);
@@ -232,6 +287,13 @@ namespace ams::fssystem {
             s32 GetEntryCount() const { return this->entry_count; }
             IAllocator *GetAllocator() const { return this->node_l1.GetAllocator(); }
 
+            void GetCacheStatistics(CacheStatistics *out) const {
+                AMS_ASSERT(out != nullptr);
+
+                std::scoped_lock lk(this->node_cache);
+                this->node_cache.GetStatistics(out);
+            }
+
             s64 GetStart() const { return this->start_offset; }
             s64 GetEnd() const { return this->end_offset; }
             s64 GetSize() const { return this->end_offset - this->start_offset; }
@@ -320,10 +382,12 @@ namespace ams::fssystem {
 
             Result FindEntrySet(s32 *out_index, s64 virtual_address, s32 node_index);
             Result FindEntrySetWithBuffer(s32 *out_index, s64 virtual_address, s32 node_index, char *buffer);
+            Result FindEntrySetInBuffer(s32 *out_index, s64 virtual_address, const char *buffer);
             Result FindEntrySetWithoutBuffer(s32 *out_index, s64 virtual_address, s32 node_index);
 
             Result FindEntry(s64 virtual_address, s32 entry_set_index);
             Result FindEntryWithBuffer(s64 virtual_address, s32 entry_set_index, char *buffer);
+            Result FindEntryInBuffer(s64 virtual_address, const char *buffer);
             Result FindEntryWithoutBuffer(s64 virtual_address, s32 entry_set_index);
     };
 
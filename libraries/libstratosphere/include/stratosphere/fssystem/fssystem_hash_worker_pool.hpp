@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <vapours.hpp>
+
+namespace ams::fssystem {
+
+    constexpr inline s32 HashWorkerCountMax = 3;
+
+    /* Starts worker threads which help hash large reads of hierarchical sha256 storages. */
+    /* The stack must hold worker_count stacks of stack_size bytes each, and must remain valid for the lifetime of the process. */
+    void InitializeHashWorkerPool(void *stack, size_t stack_size, s32 worker_count);
+
+    /* Generates the sha256 hash of each block_size block of src, using the worker pool when it is initialized and free. */
+    void GenerateSha256Hashes(void *dst, size_t dst_size, const void *src, size_t src_size, size_t block_size);
+
+}
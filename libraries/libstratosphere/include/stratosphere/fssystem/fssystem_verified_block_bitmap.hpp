@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <vapours.hpp>
+#include <stratosphere/os.hpp>
+#include <stratosphere/fs/fs_memory_management.hpp>
+
+namespace ams::fssystem {
+
+    struct VerificationStatistics {
+        s64 read_size;
+        s64 hashed_size;
+    };
+    static_assert(util::is_pod<VerificationStatistics>::value);
+
+    /* Remembers which blocks of a storage have already passed hash verification, so that reading them again needn't re-hash them. */
+    /* Blocks past what the bitmap can track are always verified. */
+    class VerifiedBlockBitmap {
+        NON_COPYABLE(VerifiedBlockBitmap);
+        NON_MOVEABLE(VerifiedBlockBitmap);
+        public:
+            static constexpr size_t BitmapSizeMax = 4_KB;
+            static constexpr s64 BlockCountMax    = BitmapSizeMax * BITSIZEOF(u8);
+        private:
+            /* TODO: SdkMutex */
+            os::Mutex mutex;
+            std::unique_ptr<u64[], fs::impl::Deleter> bitmap;
+            s64 block_count;
+            std::atomic<s64> read_size;
+            std::atomic<s64> hashed_size;
+        public:
+            VerifiedBlockBitmap() : mutex(false), bitmap(), block_count(), read_size(), hashed_size() { /* ... */ }
+
+            Result Initialize(s64 block_count);
+            void Finalize();
+
+            bool IsInitialized() const { return this->bitmap != nullptr; }
+
+            bool IsVerified(s64 block_index, s64 count);
+            void SetVerified(s64 block_index, s64 count);
+
+            void Invalidate(s64 block_index, s64 count);
+            void InvalidateAll();
+
+            void AddReadSize(s64 size) { this->read_size += size; }
+            void AddHashedSize(s64 size) { this->hashed_size += size; }
+
+            void GetStatistics(VerificationStatistics *out) const {
+                AMS_ASSERT(out != nullptr);
+                out->read_size   = this->read_size;
+                out->hashed_size = this->hashed_size;
+            }
+        private:
+            s64 GetTrackedCount(s64 block_index, s64 count) const {
+                return std::max<s64>(0, std::min(block_index + count, this->block_count) - block_index);
+            }
+
+            bool GetBit(s64 index) const {
+                return (this->bitmap[index / BITSIZEOF(u64)] & (UINT64_C(1) << (index % BITSIZEOF(u64)))) != 0;
+            }
+    };
+
+}
@@ -23,6 +23,7 @@
 #include <stratosphere/fssystem/save/fssystem_save_types.hpp>
 #include <stratosphere/fssystem/save/fssystem_i_save_file_system_driver.hpp>
 #include <stratosphere/fssystem/save/fssystem_block_cache_buffered_storage.hpp>
+#include <stratosphere/fssystem/fssystem_verified_block_bitmap.hpp>
 
 namespace ams::fssystem::save {
 
@@ -47,6 +48,7 @@ namespace ams::fssystem::save {
             fs::HashSalt salt;
             bool is_real_data;
             fs::StorageType storage_type;
+            VerifiedBlockBitmap verified_bitmap;
         public:
             IntegrityVerificationStorage() : verification_block_size(0), verification_block_order(0), upper_layer_verification_block_size(0), upper_layer_verification_block_order(0), buffer_manager(nullptr) { /* ... */ }
             virtual ~IntegrityVerificationStorage() override { this->Finalize(); }
@@ -54,6 +56,13 @@ namespace ams::fssystem::save {
             Result Initialize(fs::SubStorage hs, fs::SubStorage ds, s64 verif_block_size, s64 upper_layer_verif_block_size, IBufferManager *bm, const fs::HashSalt &salt, bool is_real_data, fs::StorageType storage_type);
             void Finalize();
 
+            /* Lets repeated reads of the same blocks skip re-hashing them. Only sensible when the data can't change other than through us. */
+            Result EnableVerifiedBlockBitmap();
+
+            void GetVerificationStatistics(VerificationStatistics *out) const {
+                return this->verified_bitmap.GetStatistics(out);
+            }
+
             virtual Result Read(s64 offset, void *buffer, size_t size) override;
             virtual Result Write(s64 offset, const void *buffer, size_t size) override;
 
@@ -60,4 +60,61 @@ namespace ams::kvdb {
             }
     };
 
+    /* Functionality for parsing/generating a journal of changes to a key value archive. */
+    enum JournalRecordType : u32 {
+        JournalRecordType_Set    = 0,
+        JournalRecordType_Remove = 1,
+    };
+
+    class JournalReader {
+        private:
+            AutoBuffer &buffer;
+            size_t offset;
+        public:
+            JournalReader(AutoBuffer &b) : buffer(b), offset(0) { /* ... */ }
+        private:
+            Result Peek(void *dst, size_t size);
+            Result Read(void *dst, size_t size);
+        public:
+            Result ReadHeader(void *out_archive_hash, size_t hash_size);
+
+            bool HasRecord() const {
+                return this->offset < this->buffer.GetSize();
+            }
+
+            size_t GetOffset() const {
+                return this->offset;
+            }
+
+            Result GetRecordInfo(JournalRecordType *out_type, size_t *out_key_size, size_t *out_value_size);
+            Result ReadRecord(void *out_key, size_t key_size, void *out_value, size_t value_size);
+    };
+
+    class JournalWriter {
+        private:
+            AutoBuffer &buffer;
+            size_t offset;
+        public:
+            JournalWriter(AutoBuffer &b) : buffer(b), offset(0) { /* ... */ }
+        private:
+            Result Write(const void *src, size_t size);
+        public:
+            void WriteHeader(const void *archive_hash, size_t hash_size);
+            void WriteRecord(JournalRecordType type, const void *key, size_t key_size, const void *value, size_t value_size);
+    };
+
+    class JournalSizeHelper {
+        private:
+            size_t size;
+        public:
+            JournalSizeHelper() : size(0) { /* ... */ }
+
+            void AddHeader();
+            void AddRecord(size_t key_size, size_t value_size);
+
+            size_t GetSize() const {
+                return this->size;
+            }
+    };
+
 }
\ No newline at end of file
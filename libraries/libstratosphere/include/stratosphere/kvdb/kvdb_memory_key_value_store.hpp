@@ -254,13 +254,23 @@ namespace ams::kvdb {
             };
         private:
             using Path = kvdb::BoundedString<fs::EntryNameLengthMax>;
+
+            static constexpr size_t JournalKeyCountMax = 0x40;
         private:
             Index index;
             Path path;
             Path temp_path;
+            Path journal_path;
             MemoryResource *memory_resource;
+            size_t journal_size_max;
+            size_t journal_size;
+            size_t journal_key_count;
+            bool journal_key_overflow;
+            Key journal_keys[JournalKeyCountMax];
+            u8 archive_hash[crypto::Sha256Generator::HashSize];
+            bool has_archive_hash;
         public:
-            MemoryKeyValueStore() { /* ... */ }
+            MemoryKeyValueStore() : journal_size_max(0), journal_size(0), journal_key_count(0), journal_key_overflow(false), archive_hash(), has_archive_hash(false) { /* ... */ }
 
             Result Initialize(const char *dir, size_t capacity, MemoryResource *mr) {
                 /* Ensure that the passed path is a directory. */
@@ -271,11 +281,15 @@ namespace ams::kvdb {
                 /* Set paths. */
                 this->path.SetFormat("%s%s", dir, "/imkvdb.arc");
                 this->temp_path.SetFormat("%s%s", dir, "/imkvdb.tmp");
+                this->journal_path.SetFormat("%s%s", dir, "/imkvdb.jnl");
 
                 /* Initialize our index. */
                 R_TRY(this->index.Initialize(capacity, mr));
                 this->memory_resource = mr;
 
+                /* We don't know what the archive on disk contains until we load or save it. */
+                this->has_archive_hash = false;
+
                 return ResultSuccess();
             }
 
@@ -284,6 +298,7 @@ namespace ams::kvdb {
                 /* A store initialized this way cannot have its contents loaded from or flushed to disk. */
                 this->path.Set("");
                 this->temp_path.Set("");
+                this->journal_path.Set("");
 
                 /* Initialize our index. */
                 R_TRY(this->index.Initialize(capacity, mr));
@@ -299,68 +314,55 @@ namespace ams::kvdb {
                 return this->index.GetCapacity();
             }
 
+            void EnableJournal(size_t max_journal_size) {
+                /* Once enabled, Save appends the entries changed since the last save to a journal, */
+                /* and only rewrites the archive when the journal would grow past max_journal_size. */
+                /* NOTE: Journals are not understood by Nintendo's implementation, which only reads the archive. */
+                AMS_ABORT_UNLESS(this->path.GetLength() > 0);
+                this->journal_size_max = max_journal_size;
+            }
+
             Result Load() {
                 /* Reset any existing entries. */
                 this->index.ResetEntries();
+                this->has_archive_hash = false;
 
-                /* Try to read the archive -- note, path not found is a success condition. */
-                /* This is because no archive file = no entries, so we're in the right state. */
-                AutoBuffer buffer;
-                R_TRY_CATCH(this->ReadArchiveFile(&buffer)) {
-                    R_CONVERT(fs::ResultPathNotFound, ResultSuccess());
-                } R_END_TRY_CATCH;
-
-                /* Parse entries from the buffer. */
-                {
-                    ArchiveReader reader(buffer);
-
-                    size_t entry_count = 0;
-                    R_TRY(reader.ReadEntryCount(&entry_count));
-
-                    for (size_t i = 0; i < entry_count; i++) {
-                        /* Get size of key/value. */
-                        size_t key_size = 0, value_size = 0;
-                        R_TRY(reader.GetEntrySize(&key_size, &value_size));
-
-                        /* Allocate memory for value. */
-                        void *new_value = this->memory_resource->Allocate(value_size);
-                        R_UNLESS(new_value != nullptr, ResultAllocationFailed());
-                        auto value_guard = SCOPE_GUARD { this->memory_resource->Deallocate(new_value, value_size); };
-
-                        /* Read key and value. */
-                        Key key;
-                        R_TRY(reader.ReadEntry(&key, sizeof(key), new_value, value_size));
-                        R_TRY(this->index.AddUnsafe(key, new_value, value_size));
+                /* Load the archive, then apply any changes journaled since it was written. */
+                R_TRY(this->LoadArchive());
+                return this->LoadJournal();
+            }
 
-                        /* We succeeded, so cancel the value guard to prevent deallocation. */
-                        value_guard.Cancel();
+            Result Save(bool destructive = false) {
+                /* If we can, just append what changed to the journal. */
+                /* NOTE: Appending never touches the archive, so destructive (which only controls how the archive is rewritten) doesn't apply. */
+                /* NOTE: A journal must identify the archive it applies to, so until we've loaded or written the archive we always write it in full. */
+                if (this->journal_size_max > 0 && !this->journal_key_overflow && this->has_archive_hash) {
+                    const size_t append_size = this->GetJournalAppendSize();
+                    if (this->journal_size + append_size <= this->journal_size_max) {
+                        return this->AppendJournal(append_size);
                     }
                 }
 
-                return ResultSuccess();
+                return this->SaveArchive(destructive);
             }
 
-            Result Save(bool destructive = false) {
-                /* Create a buffer to hold the archive. */
-                AutoBuffer buffer;
-                R_TRY(buffer.Initialize(this->GetArchiveSize()));
+            bool HasJournal() const {
+                return this->journal_size > 0;
+            }
 
-                /* Write the archive to the buffer. */
-                {
-                    ArchiveWriter writer(buffer);
-                    writer.WriteHeader(this->GetCount());
-                    for (const auto &it : this->index) {
-                        const auto &key = it.GetKey();
-                        writer.WriteEntry(&key, sizeof(Key), it.GetValuePointer(), it.GetValueSize());
-                    }
-                }
+            Result CompactJournal() {
+                /* Fold the journal back into the archive, so that readers which don't understand journals see every saved change. */
+                /* NOTE: This is only done when nothing has changed since the last save, as rewriting the archive would otherwise save those changes too. */
+                R_SUCCEED_IF(this->journal_size == 0);
+                R_SUCCEED_IF(this->journal_key_count > 0 || this->journal_key_overflow);
 
-                /* Save the buffer to disk. */
-                return this->Commit(buffer, destructive);
+                return this->SaveArchive(false);
             }
 
             Result Set(const Key &key, const void *value, size_t value_size) {
-                return this->index.Set(key, value, value_size);
+                R_TRY(this->index.Set(key, value, value_size));
+                this->AddJournalKey(key);
+                return ResultSuccess();
             }
 
             template<typename Value>
@@ -428,7 +430,9 @@ namespace ams::kvdb {
             }
 
             Result Remove(const Key &key) {
-                return this->index.Remove(key);
+                R_TRY(this->index.Remove(key));
+                this->AddJournalKey(key);
+                return ResultSuccess();
             }
 
             Entry *begin() {
@@ -517,10 +521,248 @@ namespace ams::kvdb {
                 return size_helper.GetSize();
             }
 
+            Result SaveArchive(bool destructive) {
+                /* Create a buffer to hold the archive. */
+                AutoBuffer buffer;
+                R_TRY(buffer.Initialize(this->GetArchiveSize()));
+
+                /* Write the archive to the buffer. */
+                {
+                    ArchiveWriter writer(buffer);
+                    writer.WriteHeader(this->GetCount());
+                    for (const auto &it : this->index) {
+                        const auto &key = it.GetKey();
+                        writer.WriteEntry(&key, sizeof(Key), it.GetValuePointer(), it.GetValueSize());
+                    }
+                }
+
+                /* Save the buffer to disk. */
+                R_TRY(this->Commit(buffer, destructive));
+
+                /* The archive now contains everything, so discard the journal. */
+                /* If we're interrupted before the journal is deleted, the journal won't match the new archive's hash, and won't be replayed over it. */
+                crypto::GenerateSha256Hash(this->archive_hash, sizeof(this->archive_hash), buffer.Get(), buffer.GetSize());
+                this->has_archive_hash = true;
+                return this->ResetJournal();
+            }
+
+            Result LoadArchive() {
+                /* Try to read the archive -- note, path not found is a success condition. */
+                /* This is because no archive file = no entries, so we're in the right state. */
+                AutoBuffer buffer;
+                R_TRY_CATCH(this->ReadArchiveFile(&buffer)) {
+                    R_CATCH(fs::ResultPathNotFound) {
+                        crypto::GenerateSha256Hash(this->archive_hash, sizeof(this->archive_hash), nullptr, 0);
+                        this->has_archive_hash = true;
+                        return ResultSuccess();
+                    }
+                } R_END_TRY_CATCH;
+
+                /* Remember which archive we loaded, so that we only replay a journal written against it. */
+                crypto::GenerateSha256Hash(this->archive_hash, sizeof(this->archive_hash), buffer.Get(), buffer.GetSize());
+
+                /* Parse entries from the buffer. */
+                {
+                    ArchiveReader reader(buffer);
+
+                    size_t entry_count = 0;
+                    R_TRY(reader.ReadEntryCount(&entry_count));
+
+                    for (size_t i = 0; i < entry_count; i++) {
+                        /* Get size of key/value. */
+                        size_t key_size = 0, value_size = 0;
+                        R_TRY(reader.GetEntrySize(&key_size, &value_size));
+
+                        /* Allocate memory for value. */
+                        void *new_value = this->memory_resource->Allocate(value_size);
+                        R_UNLESS(new_value != nullptr, ResultAllocationFailed());
+                        auto value_guard = SCOPE_GUARD { this->memory_resource->Deallocate(new_value, value_size); };
+
+                        /* Read key and value. */
+                        Key key;
+                        R_TRY(reader.ReadEntry(&key, sizeof(key), new_value, value_size));
+                        R_TRY(this->index.AddUnsafe(key, new_value, value_size));
+
+                        /* We succeeded, so cancel the value guard to prevent deallocation. */
+                        value_guard.Cancel();
+                    }
+                }
+
+                this->has_archive_hash = true;
+                return ResultSuccess();
+            }
+
+            void AddJournalKey(const Key &key) {
+                /* If we're not journaling, or already have to rewrite the archive, there's nothing to track. */
+                if (this->journal_size_max == 0 || this->journal_key_overflow) {
+                    return;
+                }
+
+                /* Check if the key is already tracked. */
+                for (size_t i = 0; i < this->journal_key_count; i++) {
+                    if (this->journal_keys[i] == key) {
+                        return;
+                    }
+                }
+
+                /* If we're tracking too many keys, fall back to rewriting the archive. */
+                if (this->journal_key_count >= JournalKeyCountMax) {
+                    this->journal_key_overflow = true;
+                    return;
+                }
+
+                this->journal_keys[this->journal_key_count++] = key;
+            }
+
+            size_t GetJournalAppendSize() const {
+                /* If nothing changed, there's nothing to append. */
+                if (this->journal_key_count == 0) {
+                    return 0;
+                }
+
+                /* A new journal starts with a header identifying the archive it applies to. */
+                JournalSizeHelper size_helper;
+                if (this->journal_size == 0) {
+                    size_helper.AddHeader();
+                }
+
+                for (size_t i = 0; i < this->journal_key_count; i++) {
+                    if (auto it = this->find(this->journal_keys[i]); it != this->end()) {
+                        size_helper.AddRecord(sizeof(Key), it->GetValueSize());
+                    } else {
+                        size_helper.AddRecord(sizeof(Key), 0);
+                    }
+                }
+
+                return size_helper.GetSize();
+            }
+
+            Result AppendJournal(size_t append_size) {
+                /* If nothing changed, there's nothing to do. */
+                if (append_size == 0) {
+                    return ResultSuccess();
+                }
+
+                /* Create a buffer to hold the new records. */
+                AutoBuffer buffer;
+                R_TRY(buffer.Initialize(append_size));
+
+                /* Write the current state of every changed key to the buffer. */
+                {
+                    JournalWriter writer(buffer);
+                    if (this->journal_size == 0) {
+                        writer.WriteHeader(this->archive_hash, sizeof(this->archive_hash));
+                    }
+                    for (size_t i = 0; i < this->journal_key_count; i++) {
+                        const auto &key = this->journal_keys[i];
+                        if (auto it = this->find(key); it != this->end()) {
+                            writer.WriteRecord(JournalRecordType_Set, &key, sizeof(Key), it->GetValuePointer(), it->GetValueSize());
+                        } else {
+                            writer.WriteRecord(JournalRecordType_Remove, &key, sizeof(Key), nullptr, 0);
+                        }
+                    }
+                }
+
+                /* Create the journal, if it doesn't exist. */
+                R_TRY_CATCH(fs::CreateFile(this->journal_path.Get(), 0)) {
+                    R_CATCH(fs::ResultPathAlreadyExists) { /* The journal already exists, so we'll append to it. */ }
+                } R_END_TRY_CATCH;
+
+                /* Write the records after the last valid record. */
+                {
+                    fs::FileHandle file;
+                    R_TRY(fs::OpenFile(std::addressof(file), this->journal_path.Get(), fs::OpenMode_Write | fs::OpenMode_AllowAppend));
+                    ON_SCOPE_EXIT { fs::CloseFile(file); };
+
+                    /* Discard anything following the last valid record (a torn append, or a journal for a different archive), */
+                    /* so that stale records can never follow the ones we write. The file is only ever extended by the write itself. */
+                    R_TRY(fs::SetFileSize(file, this->journal_size));
+                    R_TRY(fs::WriteFile(file, this->journal_size, buffer.Get(), buffer.GetSize(), fs::WriteOption::Flush));
+                }
+
+                this->journal_size += append_size;
+                this->journal_key_count = 0;
+                return ResultSuccess();
+            }
+
+            Result LoadJournal() {
+                /* Reset journal tracking. */
+                this->journal_size = 0;
+                this->journal_key_count = 0;
+                this->journal_key_overflow = false;
+
+                /* Try to read the journal -- note, path not found is a success condition. */
+                AutoBuffer buffer;
+                R_TRY_CATCH(this->ReadFile(&buffer, this->journal_path.Get())) {
+                    R_CONVERT(fs::ResultPathNotFound, ResultSuccess());
+                } R_END_TRY_CATCH;
+
+                /* Only replay the journal if it was written against the archive we loaded. */
+                /* Otherwise, it's left over from before the archive was last rewritten, and the next append will replace it. */
+                JournalReader reader(buffer);
+                {
+                    u8 journal_archive_hash[crypto::Sha256Generator::HashSize];
+                    if (R_FAILED(reader.ReadHeader(journal_archive_hash, sizeof(journal_archive_hash))) || std::memcmp(journal_archive_hash, this->archive_hash, sizeof(this->archive_hash)) != 0) {
+                        return ResultSuccess();
+                    }
+                }
+                this->journal_size = reader.GetOffset();
+
+                /* Replay records from the buffer. */
+                while (reader.HasRecord()) {
+                    /* Get the record's type and sizes. A record that can't be parsed or fails its checksum was torn by an interrupted append, */
+                    /* so we stop replaying there, and the next append will overwrite it. */
+                    JournalRecordType type;
+                    size_t key_size = 0, value_size = 0;
+                    if (R_FAILED(reader.GetRecordInfo(&type, &key_size, &value_size)) || key_size != sizeof(Key)) {
+                        break;
+                    }
+
+                    if (type == JournalRecordType_Set) {
+                        /* Allocate memory for value. */
+                        void *new_value = this->memory_resource->Allocate(value_size);
+                        R_UNLESS(new_value != nullptr, ResultAllocationFailed());
+                        ON_SCOPE_EXIT { this->memory_resource->Deallocate(new_value, value_size); };
+
+                        /* Read key and value, and apply them. */
+                        Key key;
+                        R_TRY(reader.ReadRecord(&key, sizeof(key), new_value, value_size));
+                        R_TRY(this->index.Set(key, new_value, value_size));
+                    } else {
+                        /* Read key, and remove it. */
+                        Key key;
+                        R_TRY(reader.ReadRecord(&key, sizeof(key), nullptr, 0));
+                        R_TRY_CATCH(this->index.Remove(key)) {
+                            R_CATCH(ResultKeyNotFound) { /* The key may have been set and removed since the archive was written. */ }
+                        } R_END_TRY_CATCH;
+                    }
+
+                    this->journal_size = reader.GetOffset();
+                }
+
+                return ResultSuccess();
+            }
+
+            Result ResetJournal() {
+                this->journal_size = 0;
+                this->journal_key_count = 0;
+                this->journal_key_overflow = false;
+
+                R_TRY_CATCH(fs::DeleteFile(this->journal_path.Get())) {
+                    R_CATCH(fs::ResultPathNotFound) { /* There was no journal to discard. */ }
+                } R_END_TRY_CATCH;
+
+                return ResultSuccess();
+            }
+
             Result ReadArchiveFile(AutoBuffer *dst) const {
+                return this->ReadFile(dst, this->path.Get());
+            }
+
+            Result ReadFile(AutoBuffer *dst, const char *file_path) const {
                 /* Open the file. */
                 fs::FileHandle file;
-                R_TRY(fs::OpenFile(std::addressof(file), path, fs::OpenMode_Read));
+                R_TRY(fs::OpenFile(std::addressof(file), file_path, fs::OpenMode_Read));
                 ON_SCOPE_EXIT { fs::CloseFile(file); };
 
                 /* Get the archive file size. */
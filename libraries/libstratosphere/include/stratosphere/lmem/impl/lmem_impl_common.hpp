@@ -34,6 +34,8 @@ namespace ams::lmem::impl {
 
     using ExpHeapMemoryBlockList = typename util::IntrusiveListMemberTraits<&ExpHeapMemoryBlockHead::list_node>::ListType;
 
+    struct ExpHeapFreeBinTable;
+
     struct ExpHeapHead {
         ExpHeapMemoryBlockList free_list;
         ExpHeapMemoryBlockList used_list;
@@ -41,8 +43,9 @@ namespace ams::lmem::impl {
         u16 mode;
         bool use_alignment_margins;
         char pad[3];
+        ExpHeapFreeBinTable *free_bins;
     };
-    static_assert(sizeof(ExpHeapHead) == 0x28);
+    static_assert(sizeof(ExpHeapHead) == 0x30);
     static_assert(std::is_trivially_destructible<ExpHeapHead>::value);
 
     struct FrameHeapHead {
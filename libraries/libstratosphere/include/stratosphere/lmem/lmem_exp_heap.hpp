@@ -23,6 +23,7 @@ namespace ams::lmem {
     enum AllocationMode {
         AllocationMode_FirstFit,
         AllocationMode_BestFit,
+        AllocationMode_SegregatedFit,
     };
 
     enum AllocationDirection {
@@ -21,6 +21,7 @@ namespace ams::os {
 
     struct WaitableHolderType;
     struct WaitableManagerType;
+    struct WaitableManagerStatistics;
 
     void InitializeWaitableManager(WaitableManagerType *manager);
     void FinalizeWaitableManager(WaitableManagerType *manager);
@@ -42,4 +43,6 @@ namespace ams::os {
 
     void InitializeWaitableHolder(WaitableHolderType *holder, Handle handle);
 
+    void GetWaitableManagerStatistics(WaitableManagerStatistics *out, WaitableManagerType *manager);
+
 }
@@ -24,6 +24,8 @@ namespace ams::os {
         class WaitableManagerImpl;
         struct WaitableHolderImpl;
 
+        constexpr inline size_t WaitableManagerUserObjectCountMax = 8;
+
     }
 
     struct WaitableManagerType {
@@ -34,10 +36,17 @@ namespace ams::os {
 
         u8 state;
         bool is_waiting;
-        util::TypedStorage<impl::WaitableManagerImpl, sizeof(util::IntrusiveListNode) + sizeof(impl::InternalCriticalSection) + 2 * sizeof(void *) + sizeof(Handle), alignof(void *)> impl_storage;
+        util::TypedStorage<impl::WaitableManagerImpl, sizeof(util::IntrusiveListNode) + sizeof(impl::InternalCriticalSection) + 2 * sizeof(void *) + sizeof(Handle) +
+                                                      svc::ArgumentHandleCountMax * (sizeof(void *) + sizeof(Handle)) + impl::WaitableManagerUserObjectCountMax * sizeof(void *) +
+                                                      2 * sizeof(u64) + 2 * sizeof(s32), alignof(void *)> impl_storage;
     };
     static_assert(std::is_trivial<WaitableManagerType>::value);
 
+    struct WaitableManagerStatistics {
+        u64 wait_count;
+        u64 handle_array_update_count;
+    };
+
     struct WaitableHolderType {
         util::TypedStorage<impl::WaitableHolderImpl, 2 * sizeof(util::IntrusiveListNode) + 3 * sizeof(void *), alignof(void *)> impl_storage;
         uintptr_t user_data;
@@ -23,4 +23,18 @@ namespace ams::patcher {
     /* Helper for applying to code binaries. */
     void LocateAndApplyIpsPatchesToModule(const char *mount_name, const char *patch_dir, size_t protected_size, size_t offset, const ro::ModuleId *module_id, u8 *mapped_module, size_t mapped_size);
 
+    /* Requests that the files in every patch subdirectory be checked for changes before the index of patch files is next used. */
+    /* This should be called once before patching a group of modules (e.g. those of a single process), rather than before each module. */
+    void RequestPatchIndexRevalidation();
+
+    struct PatchIndexStatistics {
+        u64 build_count;
+        TimeSpan build_time;
+        u64 lookup_count;
+        TimeSpan lookup_time;
+    };
+
+    /* Gets the time spent building and consulting the index of patch files. */
+    void GetPatchIndexStatistics(PatchIndexStatistics *out);
+
 }
@@ -90,8 +90,25 @@ namespace ams::sf::cmif {
                 static constexpr size_t NumEntries = N;
             private:
                 const std::array<ServiceCommandMeta, N> entries;
+            private:
+                static constexpr std::array<ServiceCommandMeta, N> SortEntries(const std::array<ServiceCommandMeta, N> &e) {
+                    /* Sort entries by command id, so that handlers can be found by binary search. */
+                    /* NOTE: This is an insertion sort, so that entries with the same command id keep their relative order. */
+                    std::array<ServiceCommandMeta, N> sorted = e;
+                    for (size_t i = 1; i < N; ++i) {
+                        const ServiceCommandMeta cur = sorted[i];
+
+                        size_t j = i;
+                        while (j > 0 && sorted[j - 1].cmd_id > cur.cmd_id) {
+                            sorted[j] = sorted[j - 1];
+                            --j;
+                        }
+                        sorted[j] = cur;
+                    }
+                    return sorted;
+                }
             public:
-                explicit constexpr ServiceDispatchTableImpl(const std::array<ServiceCommandMeta, N> &e) : entries{e} { /* ... */ }
+                explicit constexpr ServiceDispatchTableImpl(const std::array<ServiceCommandMeta, N> &e) : entries{SortEntries(e)} { /* ... */ }
 
                 Result ProcessMessage(ServiceDispatchContext &ctx, const cmif::PointerAndSize &in_raw_data) const {
                     return this->ProcessMessageImpl(ctx, in_raw_data, this->entries.data(), this->entries.size());
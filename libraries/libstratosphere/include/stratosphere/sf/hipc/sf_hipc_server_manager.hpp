@@ -29,6 +29,11 @@ namespace ams::sf::hipc {
     static constexpr size_t ServerSessionCountMax = 0x40;
     static_assert(ServerSessionCountMax == 0x40, "ServerSessionCountMax isn't 0x40 somehow, this assert is a reminder that this will break lots of things");
 
+    /* Managers with more than ServerSessionCountMax servers and sessions wait on the excess from helper threads, each of which */
+    /* waits on a shard of up to ServerSessionCountMax waitables and forwards whichever becomes signaled to the processing threads. */
+    static constexpr size_t WaitShardMainTierReservedCount = 4;
+    static constexpr size_t WaitShardThreadStackSize       = 8_KB;
+
     template<size_t, typename, size_t>
     class ServerManager;
 
@@ -47,6 +52,30 @@ namespace ams::sf::hipc {
             using ServerDomainSessionManager::DomainEntryStorage;
             using ServerDomainSessionManager::DomainStorage;
         protected:
+            class WaitShard {
+                friend class ServerManagerBase;
+                NON_COPYABLE(WaitShard);
+                NON_MOVEABLE(WaitShard);
+                private:
+                    ServerManagerBase *manager;
+                    os::WaitableManagerType waitable_manager;
+                    os::Event notify_event;
+                    os::WaitableHolderType notify_event_holder;
+                    os::WaitableManagerType waitlist;
+                    os::ThreadType thread;
+                    void *thread_stack;
+                    size_t count;
+                    bool is_started;
+                    bool is_stop_requested;
+                public:
+                    WaitShard() : manager(nullptr), notify_event(os::EventClearMode_ManualClear), thread_stack(nullptr), count(0), is_started(false), is_stop_requested(false) {
+                        os::InitializeWaitableManager(std::addressof(this->waitable_manager));
+                        os::InitializeWaitableHolder(std::addressof(this->notify_event_holder), this->notify_event.GetBase());
+                        os::LinkWaitableHolder(std::addressof(this->waitable_manager), std::addressof(this->notify_event_holder));
+                        os::InitializeWaitableManager(std::addressof(this->waitlist));
+                    }
+            };
+
             class Server : public os::WaitableHolderType {
                 friend class ServerManagerBase;
                 template<size_t, typename, size_t>
@@ -84,11 +113,38 @@ namespace ams::sf::hipc {
 
             os::Mutex waitlist_mutex;
             os::WaitableManagerType waitlist;
+
+            /* Tiered waiting, protected by waitlist_mutex. */
+            WaitShard *wait_shards;
+            size_t num_wait_shards;
+            size_t main_tier_capacity;
+            size_t main_tier_count;
+            os::WaitableHolderType **ready_holders;
+            size_t ready_holders_capacity;
+            size_t ready_holders_head;
+            size_t ready_holders_count;
         private:
             virtual void RegisterSessionToWaitList(ServerSession *session) override final;
             void RegisterToWaitList(os::WaitableHolderType *holder);
             void ProcessWaitList();
 
+            void StartWaitShard(WaitShard *shard);
+            void LoopProcessWaitShard(WaitShard *shard);
+            os::WaitableHolderType *TakeReadyHolder();
+
+            static void WaitShardThreadFunction(void *arg);
+
+            static bool IsServerOrSession(const os::WaitableHolderType *holder) {
+                switch (static_cast<UserDataTag>(os::GetWaitableHolderUserData(holder))) {
+                    case UserDataTag::Server:
+                    case UserDataTag::Session:
+                    case UserDataTag::MitmServer:
+                        return true;
+                    default:
+                        return false;
+                }
+            }
+
             bool WaitAndProcessImpl();
 
             Result ProcessForServer(os::WaitableHolderType *holder);
@@ -108,7 +164,7 @@ namespace ams::sf::hipc {
                     os::SetWaitableHolderUserData(server, static_cast<uintptr_t>(UserDataTag::Server));
                 }
 
-                os::LinkWaitableHolder(std::addressof(this->waitable_manager), server);
+                this->RegisterToWaitList(server);
             }
 
             void RegisterServerImpl(int index, cmif::ServiceObjectHolder &&static_holder, Handle port_handle, bool is_mitm_server) {
@@ -188,11 +244,27 @@ namespace ams::sf::hipc {
             Result AcceptMitmImpl(Server *server, SharedPointer<Interface> p, std::shared_ptr<::Service> forward_service) {
                 return ServerSessionManager::AcceptMitmSession(server->port_handle, std::move(p), std::move(forward_service));
             }
+
+            void SetupWaitShards(WaitShard *shards, size_t num_shards, void *shard_stacks, size_t main_capacity, os::WaitableHolderType **ready_storage, size_t ready_capacity) {
+                this->wait_shards            = shards;
+                this->num_wait_shards        = num_shards;
+                this->main_tier_capacity     = main_capacity;
+                this->ready_holders          = ready_storage;
+                this->ready_holders_capacity = ready_capacity;
+
+                for (size_t i = 0; i < num_shards; i++) {
+                    shards[i].manager      = this;
+                    shards[i].thread_stack = static_cast<u8 *>(shard_stacks) + i * WaitShardThreadStackSize;
+                }
+            }
+
+            void FinalizeWaitShards();
         public:
             ServerManagerBase(DomainEntryStorage *entry_storage, size_t entry_count) :
                 ServerDomainSessionManager(entry_storage, entry_count),
                 request_stop_event(os::EventClearMode_ManualClear), notify_event(os::EventClearMode_ManualClear),
-                waitable_selection_mutex(false), waitlist_mutex(false)
+                waitable_selection_mutex(false), waitlist_mutex(false), wait_shards(nullptr), num_wait_shards(0), main_tier_capacity(0), main_tier_count(0),
+                ready_holders(nullptr), ready_holders_capacity(0), ready_holders_head(0), ready_holders_count(0)
             {
                 /* Link waitables. */
                 os::InitializeWaitableManager(std::addressof(this->waitable_manager));
@@ -236,15 +308,21 @@ namespace ams::sf::hipc {
             Result Process(os::WaitableHolderType *waitable);
             void   WaitAndProcess();
             void   LoopProcess();
+
+            /* Loops on the current thread and num_extra_threads additional threads, returning once processing has stopped on all of them. */
+            /* Only one thread waits at a time; once it takes a waitable to process, the next thread begins waiting in its place. */
+            void   LoopProcessMultiThreaded(os::ThreadType *extra_threads, void *extra_thread_stacks, size_t extra_thread_stack_size, size_t num_extra_threads, s32 priority);
     };
 
     template<size_t MaxServers, typename ManagerOptions = DefaultServerManagerOptions, size_t MaxSessions = ServerSessionCountMax - MaxServers>
     class ServerManager : public ServerManagerBase {
         NON_COPYABLE(ServerManager);
         NON_MOVEABLE(ServerManager);
-        static_assert(MaxServers  <= ServerSessionCountMax, "MaxServers can never be larger than ServerSessionCountMax (0x40).");
-        static_assert(MaxSessions <= ServerSessionCountMax, "MaxSessions can never be larger than ServerSessionCountMax (0x40).");
-        static_assert(MaxServers + MaxSessions <= ServerSessionCountMax, "MaxServers + MaxSessions can never be larger than ServerSessionCountMax (0x40).");
+        private:
+            static constexpr size_t MaxWaitables     = MaxServers + MaxSessions;
+            static constexpr size_t MainTierCapacity = (MaxWaitables <= ServerSessionCountMax) ? MaxWaitables : ServerSessionCountMax - WaitShardMainTierReservedCount;
+            static constexpr size_t WaitShardCount   = util::DivideUp(MaxWaitables - MainTierCapacity, ServerSessionCountMax);
+            static constexpr size_t ReadyHolderCount = (WaitShardCount > 0) ? MaxWaitables : 0;
         private:
             static constexpr inline bool DomainCountsValid = [] {
                 if constexpr (ManagerOptions::MaxDomains > 0) {
@@ -273,6 +351,11 @@ namespace ams::sf::hipc {
             DomainStorage domain_storages[ManagerOptions::MaxDomains];
             bool domain_allocated[ManagerOptions::MaxDomains];
             DomainEntryStorage domain_entry_storages[ManagerOptions::MaxDomainObjects];
+
+            /* Tiered waiting resources. */
+            WaitShard wait_shards[WaitShardCount];
+            os::WaitableHolderType *ready_holders[ReadyHolderCount];
+            u8 wait_shard_stack_storage[(WaitShardCount > 0) ? (os::ThreadStackAlignment + WaitShardCount * WaitShardThreadStackSize) : 0];
         private:
             constexpr inline size_t GetServerIndex(const Server *server) const {
                 const size_t i = server - GetPointer(this->server_storages[0]);
@@ -385,9 +468,16 @@ namespace ams::sf::hipc {
                 /* Set resource starts. */
                 this->pointer_buffers_start = util::AlignUp(reinterpret_cast<uintptr_t>(this->pointer_buffer_storage), 0x10);
                 this->saved_messages_start  = util::AlignUp(reinterpret_cast<uintptr_t>(this->saved_message_storage),  0x10);
+
+                /* Set up tiered waiting. */
+                void *wait_shard_stacks = reinterpret_cast<void *>(util::AlignUp(reinterpret_cast<uintptr_t>(this->wait_shard_stack_storage), os::ThreadStackAlignment));
+                this->SetupWaitShards(this->wait_shards, WaitShardCount, wait_shard_stacks, MainTierCapacity, this->ready_holders, ReadyHolderCount);
             }
 
             ~ServerManager() {
+                /* Stop waiting from helper threads. */
+                this->FinalizeWaitShards();
+
                 /* Close all sessions. */
                 for (size_t i = 0; i < MaxSessions; i++) {
                     if (this->session_allocated[i]) {
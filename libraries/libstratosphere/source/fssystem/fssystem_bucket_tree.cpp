@@ -140,6 +140,78 @@ namespace ams::fssystem {
         return ResultSuccess();
     }
 
+    void BucketTree::NodeCache::Initialize(size_t node_size) {
+        AMS_ASSERT(this->block_count == 0);
+
+        this->block_count_max = static_cast<s32>(std::min<size_t>(BlockCountMax, CacheSizeMax / node_size));
+        this->counter         = 0;
+    }
+
+    void BucketTree::NodeCache::Finalize(IAllocator *allocator, size_t node_size) {
+        for (s32 i = 0; i < this->block_count; i++) {
+            allocator->Deallocate(this->blocks[i].buffer, node_size);
+            this->blocks[i].buffer = nullptr;
+        }
+        this->block_count     = 0;
+        this->block_count_max = 0;
+    }
+
+    void BucketTree::NodeCache::Invalidate() {
+        /* Keep the buffers, but make sure that nothing matches them until they're refilled. */
+        for (s32 i = 0; i < this->block_count; i++) {
+            this->blocks[i].index = -1;
+        }
+    }
+
+    const char *BucketTree::NodeCache::Find(BlockType type, s32 index) {
+        for (s32 i = 0; i < this->block_count; i++) {
+            Block &block = this->blocks[i];
+            if (block.index == index && block.type == type) {
+                block.last_used = ++this->counter;
+                ++this->hit_count;
+                return block.buffer;
+            }
+        }
+
+        ++this->miss_count;
+        return nullptr;
+    }
+
+    void BucketTree::NodeCache::Insert(IAllocator *allocator, size_t node_size, BlockType type, s32 index, const char *buffer) {
+        AMS_ASSERT(index >= 0);
+
+        /* Pick a block to fill, checking that another visitor hasn't already cached this one. */
+        Block *target = nullptr;
+        for (s32 i = 0; i < this->block_count; i++) {
+            Block &block = this->blocks[i];
+            if (block.index == index && block.type == type) {
+                return;
+            }
+
+            if (target == nullptr || block.last_used < target->last_used) {
+                target = std::addressof(block);
+            }
+        }
+
+        /* Prefer to grow the cache, if we're allowed to and can get the memory. */
+        if (this->block_count < this->block_count_max) {
+            if (char *new_buffer = static_cast<char *>(allocator->Allocate(node_size, sizeof(s64))); new_buffer != nullptr) {
+                target = std::addressof(this->blocks[this->block_count++]);
+                target->buffer = new_buffer;
+            }
+        }
+
+        /* If we have nowhere to put the block, don't cache it. */
+        if (target == nullptr) {
+            return;
+        }
+
+        std::memcpy(target->buffer, buffer, node_size);
+        target->index     = index;
+        target->type      = type;
+        target->last_used = ++this->counter;
+    }
+
     Result BucketTree::Initialize(IAllocator *allocator, fs::SubStorage node_storage, fs::SubStorage entry_storage, size_t node_size, size_t entry_size, s32 entry_count) {
         /* Validate preconditions. */
         AMS_ASSERT(allocator != nullptr);
@@ -189,6 +261,9 @@ namespace ams::fssystem {
         this->start_offset    = start_offset;
         this->end_offset      = end_offset;
 
+        /* Set up our node cache. */
+        this->node_cache.Initialize(node_size);
+
         /* Cancel guard. */
         node_guard.Cancel();
         return ResultSuccess();
@@ -208,6 +283,7 @@ namespace ams::fssystem {
         if (this->IsInitialized()) {
             this->node_storage    = fs::SubStorage();
             this->entry_storage   = fs::SubStorage();
+            this->node_cache.Finalize(this->node_l1.GetAllocator(), this->node_size);
             this->node_l1.Free(this->node_size);
             this->node_size       = 0;
             this->entry_size      = 0;
@@ -232,6 +308,12 @@ namespace ams::fssystem {
     }
 
     Result BucketTree::InvalidateCache() {
+        /* Invalidate our cached nodes and entry sets. */
+        {
+            std::scoped_lock lk(this->node_cache);
+            this->node_cache.Invalidate();
+        }
+
         /* Invalidate the node storage cache. */
         {
             s64 storage_size;
@@ -414,6 +496,14 @@ namespace ams::fssystem {
     Result BucketTree::Visitor::FindEntrySet(s32 *out_index, s64 virtual_address, s32 node_index) {
         const auto node_size = this->tree->node_size;
 
+        /* Try to find the node in the tree's cache. */
+        {
+            std::scoped_lock lk(this->tree->node_cache);
+            if (const char *cached = this->tree->node_cache.Find(NodeCache::BlockType::Node, node_index); cached != nullptr) {
+                return this->FindEntrySetInBuffer(out_index, virtual_address, cached);
+            }
+        }
+
         PooledBuffer pool(node_size, 1);
         if (node_size <= pool.GetSize()) {
             return this->FindEntrySetWithBuffer(out_index, virtual_address, node_index, pool.GetBuffer());
@@ -437,6 +527,21 @@ namespace ams::fssystem {
         std::memcpy(std::addressof(header), buffer, NodeHeaderSize);
         R_TRY(header.Verify(node_index, node_size, sizeof(s64)));
 
+        /* Cache the verified node. */
+        {
+            std::scoped_lock lk(this->tree->node_cache);
+            this->tree->node_cache.Insert(this->tree->GetAllocator(), node_size, NodeCache::BlockType::Node, node_index, buffer);
+        }
+
+        /* Find the entry set. */
+        return this->FindEntrySetInBuffer(out_index, virtual_address, buffer);
+    }
+
+    Result BucketTree::Visitor::FindEntrySetInBuffer(s32 *out_index, s64 virtual_address, const char *buffer) {
+        /* Get the header, which has already been validated. */
+        NodeHeader header;
+        std::memcpy(std::addressof(header), buffer, NodeHeaderSize);
+
         /* Create the node, and find. */
         StorageNode node(sizeof(s64), header.count);
         node.Find(buffer, virtual_address);
@@ -471,6 +576,14 @@ namespace ams::fssystem {
     Result BucketTree::Visitor::FindEntry(s64 virtual_address, s32 entry_set_index) {
         const auto entry_set_size = this->tree->node_size;
 
+        /* Try to find the entry set in the tree's cache. */
+        {
+            std::scoped_lock lk(this->tree->node_cache);
+            if (const char *cached = this->tree->node_cache.Find(NodeCache::BlockType::EntrySet, entry_set_index); cached != nullptr) {
+                return this->FindEntryInBuffer(virtual_address, cached);
+            }
+        }
+
         PooledBuffer pool(entry_set_size, 1);
         if (entry_set_size <= pool.GetSize()) {
             return this->FindEntryWithBuffer(virtual_address, entry_set_index, pool.GetBuffer());
@@ -495,6 +608,23 @@ namespace ams::fssystem {
         std::memcpy(std::addressof(entry_set), buffer, sizeof(EntrySetHeader));
         R_TRY(entry_set.header.Verify(entry_set_index, entry_set_size, entry_size));
 
+        /* Cache the verified entry set. */
+        {
+            std::scoped_lock lk(this->tree->node_cache);
+            this->tree->node_cache.Insert(this->tree->GetAllocator(), entry_set_size, NodeCache::BlockType::EntrySet, entry_set_index, buffer);
+        }
+
+        /* Find the entry. */
+        return this->FindEntryInBuffer(virtual_address, buffer);
+    }
+
+    Result BucketTree::Visitor::FindEntryInBuffer(s64 virtual_address, const char *buffer) {
+        const auto entry_size = this->tree->entry_size;
+
+        /* Get the entry set header, which has already been validated. */
+        EntrySetHeader entry_set;
+        std::memcpy(std::addressof(entry_set), buffer, sizeof(EntrySetHeader));
+
         /* Create the node, and find. */
         StorageNode node(entry_size, entry_set.info.count);
         node.Find(buffer, virtual_address);
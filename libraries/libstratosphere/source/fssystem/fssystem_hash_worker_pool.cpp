@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+
+namespace ams::fssystem {
+
+    namespace {
+
+        constexpr size_t HashSize = crypto::Sha256Generator::HashSize;
+
+        /* Hashing small reads on multiple threads costs more than it saves. */
+        constexpr size_t ParallelHashSizeMin = 64_KB;
+
+        struct HashJob {
+            u8 *hashes;
+            const u8 *data;
+            size_t data_size;
+            size_t block_size;
+            size_t block_count;
+            std::atomic<size_t> next_block;
+            size_t completed_count;
+            s32 active_worker_count;
+        };
+
+        os::ThreadType g_worker_threads[HashWorkerCountMax];
+        s32 g_worker_count;
+
+        /* TODO: SdkMutex */
+        os::Mutex g_job_lock(false);
+        os::Mutex g_mutex(false);
+        os::ConditionVariable g_job_cv;
+        os::ConditionVariable g_done_cv;
+        HashJob *g_job;
+        u32 g_job_generation;
+
+        size_t ProcessHashJob(HashJob *job) {
+            size_t processed = 0;
+            for (size_t i = job->next_block++; i < job->block_count; i = job->next_block++) {
+                const size_t offset = i * job->block_size;
+                crypto::GenerateSha256Hash(job->hashes + i * HashSize, HashSize, job->data + offset, std::min(job->block_size, job->data_size - offset));
+                ++processed;
+            }
+            return processed;
+        }
+
+        void HashWorkerThreadFunction(void *) {
+            u32 last_generation = 0;
+            while (true) {
+                /* Wait for a job we haven't worked on yet. */
+                HashJob *job;
+                {
+                    std::scoped_lock lk(g_mutex);
+                    while (g_job == nullptr || g_job_generation == last_generation) {
+                        g_job_cv.Wait(g_mutex);
+                    }
+
+                    job             = g_job;
+                    last_generation = g_job_generation;
+                    ++job->active_worker_count;
+                }
+
+                /* Hash blocks until there are none left. */
+                const size_t processed = ProcessHashJob(job);
+
+                /* Let the owner of the job know we're done with it. */
+                {
+                    std::scoped_lock lk(g_mutex);
+                    job->completed_count += processed;
+                    --job->active_worker_count;
+                    g_done_cv.Broadcast();
+                }
+            }
+        }
+
+    }
+
+    void InitializeHashWorkerPool(void *stack, size_t stack_size, s32 worker_count) {
+        AMS_ABORT_UNLESS(g_worker_count == 0);
+        AMS_ABORT_UNLESS(0 < worker_count && worker_count <= HashWorkerCountMax);
+        AMS_ABORT_UNLESS(util::IsAligned(reinterpret_cast<uintptr_t>(stack), os::ThreadStackAlignment));
+        AMS_ABORT_UNLESS(util::IsAligned(stack_size, os::ThreadStackAlignment));
+
+        for (s32 i = 0; i < worker_count; i++) {
+            void *worker_stack = static_cast<u8 *>(stack) + i * stack_size;
+            R_ABORT_UNLESS(os::CreateThread(std::addressof(g_worker_threads[i]), HashWorkerThreadFunction, nullptr, worker_stack, stack_size, AMS_GET_SYSTEM_THREAD_PRIORITY(fs, WorkerThreadPool)));
+            os::SetThreadNamePointer(std::addressof(g_worker_threads[i]), AMS_GET_SYSTEM_THREAD_NAME(fs, WorkerThreadPool));
+            os::StartThread(std::addressof(g_worker_threads[i]));
+        }
+
+        g_worker_count = worker_count;
+    }
+
+    void GenerateSha256Hashes(void *dst, size_t dst_size, const void *src, size_t src_size, size_t block_size) {
+        AMS_ASSERT(block_size > 0);
+
+        const size_t block_count = util::DivideUp(src_size, block_size);
+        AMS_ASSERT(dst_size >= block_count * HashSize);
+        AMS_UNUSED(dst_size);
+
+        /* If we can, share the work with our workers. Only one job runs at a time; anyone else hashes by themselves. */
+        if (g_worker_count > 0 && block_count > 1 && src_size >= ParallelHashSizeMin && g_job_lock.TryLock()) {
+            ON_SCOPE_EXIT { g_job_lock.Unlock(); };
+
+            HashJob job = {
+                .hashes              = static_cast<u8 *>(dst),
+                .data                = static_cast<const u8 *>(src),
+                .data_size           = src_size,
+                .block_size          = block_size,
+                .block_count         = block_count,
+                .next_block          = 0,
+                .completed_count     = 0,
+                .active_worker_count = 0,
+            };
+
+            /* Publish the job. */
+            {
+                std::scoped_lock lk(g_mutex);
+                g_job = std::addressof(job);
+                ++g_job_generation;
+                g_job_cv.Broadcast();
+            }
+
+            /* Hash alongside our workers. */
+            const size_t processed = ProcessHashJob(std::addressof(job));
+
+            /* Wait for every block to be hashed, and for every worker to let go of the job. */
+            {
+                std::scoped_lock lk(g_mutex);
+                job.completed_count += processed;
+                while (job.completed_count < job.block_count || job.active_worker_count > 0) {
+                    g_done_cv.Wait(g_mutex);
+                }
+                g_job = nullptr;
+            }
+
+            return;
+        }
+
+        /* Hash each block ourselves. */
+        for (size_t i = 0; i < block_count; i++) {
+            const size_t offset = i * block_size;
+            crypto::GenerateSha256Hash(static_cast<u8 *>(dst) + i * HashSize, HashSize, static_cast<const u8 *>(src) + offset, std::min(block_size, src_size - offset));
+        }
+    }
+
+}
@@ -91,6 +91,7 @@ namespace ams::fssystem {
         /* Read the data. */
         const size_t reduced_size = static_cast<size_t>(std::min<s64>(this->base_storage_size, util::AlignUp(offset + size, this->hash_target_block_size) - offset));
         R_TRY(this->base_storage->Read(offset, buffer, reduced_size));
+        this->verified_bitmap.AddReadSize(reduced_size);
 
         /* Temporarily increase our thread priority. */
         ScopedThreadPriorityChanger cp(+1, ScopedThreadPriorityChanger::Mode::Relative);
@@ -99,21 +100,35 @@ namespace ams::fssystem {
         auto cur_offset     = offset;
         auto remaining_size = reduced_size;
         while (remaining_size > 0) {
-            /* Generate the hash of the region we're validating. */
-            u8 hash[HashSize];
-            const auto cur_size = static_cast<size_t>(std::min<s64>(this->hash_target_block_size, remaining_size));
-            crypto::GenerateSha256Hash(hash, sizeof(hash), static_cast<u8 *>(buffer) + (cur_offset - offset), cur_size);
+            const auto cur_size    = static_cast<size_t>(std::min<s64>(VerificationBatchBlockCount * this->hash_target_block_size, remaining_size));
+            const auto cur_count   = util::DivideUp(cur_size, static_cast<size_t>(this->hash_target_block_size));
+            const auto block_index = cur_offset / this->hash_target_block_size;
+
+            /* Skip blocks which we've already verified. */
+            if (this->verified_bitmap.IsVerified(block_index, cur_count)) {
+                cur_offset     += cur_size;
+                remaining_size -= cur_size;
+                continue;
+            }
+
+            /* Generate the hashes of the blocks we're validating, in batches so that we only need to take our lock once per batch. */
+            u8 hashes[VerificationBatchBlockCount][HashSize];
+            GenerateSha256Hashes(hashes, sizeof(hashes), static_cast<u8 *>(buffer) + (cur_offset - offset), cur_size, this->hash_target_block_size);
+            this->verified_bitmap.AddHashedSize(cur_size);
 
-            AMS_ASSERT(static_cast<size_t>(cur_offset >> this->log_size_ratio) < this->hash_buffer_size);
+            AMS_ASSERT(static_cast<size_t>(cur_offset >> this->log_size_ratio) + cur_count * HashSize <= this->hash_buffer_size);
 
-            /* Check the hash. */
+            /* Check the hashes. */
             {
                 std::scoped_lock lk(this->mutex);
                 auto clear_guard = SCOPE_GUARD { std::memset(buffer, 0, size); };
 
-                R_UNLESS(crypto::IsSameBytes(hash, std::addressof(this->hash_buffer[cur_offset >> this->log_size_ratio]), HashSize), fs::ResultHierarchicalSha256HashVerificationFailed());
+                R_UNLESS(crypto::IsSameBytes(hashes, std::addressof(this->hash_buffer[cur_offset >> this->log_size_ratio]), cur_count * HashSize), fs::ResultHierarchicalSha256HashVerificationFailed());
 
                 clear_guard.Cancel();
+
+                /* Note that the blocks are verified, while a write can't change their hashes. */
+                this->verified_bitmap.SetVerified(block_index, cur_count);
             }
 
             /* Advance. */
@@ -139,6 +154,10 @@ namespace ams::fssystem {
         const size_t reduced_size = static_cast<size_t>(std::min<s64>(this->base_storage_size, util::AlignUp(offset + size, this->hash_target_block_size) - offset));
         auto cur_offset     = offset;
         auto remaining_size = reduced_size;
+
+        /* The blocks we're writing will need to be verified again. */
+        this->verified_bitmap.Invalidate(offset / this->hash_target_block_size, util::DivideUp(reduced_size, static_cast<size_t>(this->hash_target_block_size)));
+
         while (remaining_size > 0) {
             /* Generate the hash of the region we're validating. */
             u8 hash[HashSize];
@@ -156,6 +175,7 @@ namespace ams::fssystem {
             {
                 std::scoped_lock lk(this->mutex);
                 std::memcpy(std::addressof(this->hash_buffer[cur_offset >> this->log_size_ratio]), hash, HashSize);
+                this->verified_bitmap.Invalidate(cur_offset / this->hash_target_block_size, 1);
             }
 
             /* Advance. */
@@ -177,6 +197,11 @@ namespace ams::fssystem {
         /* Determine size to use. */
         const auto reduced_size = std::min<s64>(this->base_storage_size, util::AlignUp(offset + size, this->hash_target_block_size) - offset);
 
+        /* If invalidating cache, forget which blocks we've verified. */
+        if (op_id == fs::OperationId::InvalidateCache) {
+            this->verified_bitmap.Invalidate(offset / this->hash_target_block_size, util::DivideUp(reduced_size, static_cast<s64>(this->hash_target_block_size)));
+        }
+
         /* Operate on the base storage. */
         return this->base_storage->OperateRange(dst, dst_size, op_id, offset, reduced_size, src, src_size);
     }
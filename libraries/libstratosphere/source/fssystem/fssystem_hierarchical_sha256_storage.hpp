@@ -24,6 +24,8 @@ namespace ams::fssystem {
         public:
             static constexpr s32 LayerCount  = 3;
             static constexpr size_t HashSize = crypto::Sha256Generator::HashSize;
+        private:
+            static constexpr size_t VerificationBatchBlockCount = 0x20;
         private:
             os::Mutex mutex;
             IStorage *base_storage;
@@ -32,11 +34,21 @@ namespace ams::fssystem {
             size_t hash_buffer_size;
             s32 hash_target_block_size;
             s32 log_size_ratio;
+            VerifiedBlockBitmap verified_bitmap;
         public:
             HierarchicalSha256Storage() : mutex(false) { /* ... */ }
 
             Result Initialize(IStorage **base_storages, s32 layer_count, size_t htbs, void *hash_buf, size_t hash_buf_size);
 
+            /* Lets repeated reads of the same blocks skip re-hashing them. Only sensible when the base storage can't change underneath us. */
+            Result EnableVerifiedBlockBitmap() {
+                return this->verified_bitmap.Initialize(util::DivideUp(this->base_storage_size, this->hash_target_block_size));
+            }
+
+            void GetVerificationStatistics(VerificationStatistics *out) const {
+                return this->verified_bitmap.GetStatistics(out);
+            }
+
             virtual Result Read(s64 offset, void *buffer, size_t size) override;
             virtual Result Write(s64 offset, const void *buffer, size_t size) override;
             virtual Result OperateRange(void *dst, size_t dst_size, fs::OperationId op_id, s64 offset, s64 size, const void *src, size_t src_size) override;
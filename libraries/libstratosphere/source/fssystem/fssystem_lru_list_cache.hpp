@@ -30,41 +30,69 @@ namespace ams::fssystem {
                     Key key;
                     Value value;
                     util::IntrusiveListNode mru_list_node;
+                    Node *hash_next;
+                    bool is_hashed;
                 public:
-                    explicit Node(const Value &value) : value(value) { /* ... */ }
+                    explicit Node(const Value &value) : value(value), hash_next(nullptr), is_hashed(false) { /* ... */ }
             };
         private:
             using MruList = typename util::IntrusiveListMemberTraits<&Node::mru_list_node>::ListType;
+
+            static constexpr size_t InitialBucketCount = 0x10;
         private:
             MruList mru_list;
+            Node **buckets;
+            size_t bucket_count;
         public:
-            constexpr LruListCache() : mru_list() { /* ... */ }
+            constexpr LruListCache() : mru_list(), buckets(nullptr), bucket_count(0) { /* ... */ }
+
+            ~LruListCache() {
+                if (this->buckets != nullptr) {
+                    ::ams::fs::impl::Deallocate(this->buckets, sizeof(Node *) * this->bucket_count);
+                }
+            }
 
             bool FindValueAndUpdateMru(Value *out, const Key &key) {
-                for (auto it = this->mru_list.begin(); it != this->mru_list.end(); ++it) {
-                    if (it->key == key) {
-                        *out = it->value;
+                Node *node = this->FindNode(key);
+                if (node == nullptr) {
+                    return false;
+                }
 
-                        this->mru_list.erase(it);
-                        this->mru_list.push_front(*it);
+                *out = node->value;
 
-                        return true;
-                    }
-                }
+                this->mru_list.erase(this->mru_list.iterator_to(*node));
+                this->mru_list.push_front(*node);
 
-                return false;
+                return true;
             }
 
             std::unique_ptr<Node> PopLruNode() {
                 AMS_ABORT_UNLESS(!this->mru_list.empty());
                 Node *lru = std::addressof(*this->mru_list.rbegin());
                 this->mru_list.pop_back();
+                this->RemoveFromBucket(lru);
 
                 return std::unique_ptr<Node>(lru);
             }
 
             void PushMruNode(std::unique_ptr<Node> &&node, const Key &key) {
-                node->key = key;
+                node->key       = key;
+                node->is_hashed = true;
+                this->mru_list.push_front(*node);
+                this->InsertToBucket(node.get());
+                node.release();
+
+                /* Keep the hash table at least as large as the list. */
+                if (this->mru_list.size() > this->bucket_count) {
+                    this->Rehash(this->bucket_count > 0 ? 2 * this->bucket_count : InitialBucketCount);
+                }
+            }
+
+            void PushUnusedMruNode(std::unique_ptr<Node> &&node, const Key &key) {
+                /* A node which holds no valid data is kept out of the hash table, so that it can't be found, */
+                /* and so that unused nodes (which all share the same key) don't pile up in a single chain. */
+                node->key       = key;
+                node->is_hashed = false;
                 this->mru_list.push_front(*node);
                 node.release();
             }
@@ -75,6 +103,10 @@ namespace ams::fssystem {
                     this->mru_list.erase(this->mru_list.iterator_to(*lru));
                     delete lru;
                 }
+
+                if (this->buckets != nullptr) {
+                    std::memset(this->buckets, 0, sizeof(Node *) * this->bucket_count);
+                }
             }
 
             size_t GetSize() const {
@@ -84,6 +116,76 @@ namespace ams::fssystem {
             bool IsEmpty() const {
                 return this->mru_list.empty();
             }
+        private:
+            size_t GetBucketIndex(const Key &key) const {
+                /* Fibonacci hashing, so that sequential keys spread across buckets. */
+                const u64 hash = static_cast<u64>(std::hash<Key>{}(key)) * UINT64_C(0x9E3779B97F4A7C15);
+                return static_cast<size_t>(hash >> (util::CountLeadingZeros<u64>(this->bucket_count) + 1));
+            }
+
+            Node *FindNode(const Key &key) {
+                /* If we couldn't allocate a hash table, fall back to searching the list. */
+                if (this->buckets == nullptr) {
+                    for (auto &node : this->mru_list) {
+                        if (node.is_hashed && node.key == key) {
+                            return std::addressof(node);
+                        }
+                    }
+                    return nullptr;
+                }
+
+                for (Node *node = this->buckets[this->GetBucketIndex(key)]; node != nullptr; node = node->hash_next) {
+                    if (node->key == key) {
+                        return node;
+                    }
+                }
+                return nullptr;
+            }
+
+            void InsertToBucket(Node *node) {
+                if (this->buckets != nullptr) {
+                    Node **head = std::addressof(this->buckets[this->GetBucketIndex(node->key)]);
+                    node->hash_next = *head;
+                    *head = node;
+                }
+            }
+
+            void RemoveFromBucket(Node *node) {
+                if (node->is_hashed && this->buckets != nullptr) {
+                    for (Node **cur = std::addressof(this->buckets[this->GetBucketIndex(node->key)]); *cur != nullptr; cur = std::addressof((*cur)->hash_next)) {
+                        if (*cur == node) {
+                            *cur = node->hash_next;
+                            break;
+                        }
+                    }
+                }
+                node->hash_next = nullptr;
+            }
+
+            void Rehash(size_t new_bucket_count) {
+                AMS_ASSERT(util::IsPowerOfTwo(new_bucket_count));
+
+                /* Allocate the new table. If we can't, keep using the old one. */
+                Node **new_buckets = static_cast<Node **>(::ams::fs::impl::Allocate(sizeof(Node *) * new_bucket_count));
+                if (new_buckets == nullptr) {
+                    return;
+                }
+                std::memset(new_buckets, 0, sizeof(Node *) * new_bucket_count);
+
+                /* Swap in the new table. */
+                if (this->buckets != nullptr) {
+                    ::ams::fs::impl::Deallocate(this->buckets, sizeof(Node *) * this->bucket_count);
+                }
+                this->buckets      = new_buckets;
+                this->bucket_count = new_bucket_count;
+
+                /* Re-insert every node, from least to most recently used so that chains stay in MRU order. */
+                for (auto it = this->mru_list.rbegin(); it != this->mru_list.rend(); ++it) {
+                    if (it->is_hashed) {
+                        this->InsertToBucket(std::addressof(*it));
+                    }
+                }
+            }
     };
 
 }
@@ -22,20 +22,34 @@ namespace ams::fssystem {
     class ReadOnlyBlockCacheStorage : public ::ams::fs::IStorage, public ::ams::fs::impl::Newable {
         NON_COPYABLE(ReadOnlyBlockCacheStorage);
         NON_MOVEABLE(ReadOnlyBlockCacheStorage);
+        public:
+            static constexpr s32 MaxShardCount = 8;
         private:
             using BlockCache = LruListCache<s64, char *>;
+
+            /* Blocks are split between shards by index, so that reads of different blocks don't contend for one lock. */
+            struct Shard {
+                os::Mutex mutex;
+                BlockCache block_cache;
+
+                Shard() : mutex(false), block_cache() { /* ... */ }
+            };
         private:
-            os::Mutex mutex;
-            BlockCache block_cache;
+            Shard shards[MaxShardCount];
+            s32 shard_count;
             fs::IStorage * const base_storage;
             s32 block_size;
         public:
-            ReadOnlyBlockCacheStorage(IStorage *bs, s32 bsz, char *buf, size_t buf_size, s32 cache_block_count) : mutex(false), base_storage(bs), block_size(bsz) {
+            ReadOnlyBlockCacheStorage(IStorage *bs, s32 bsz, char *buf, size_t buf_size, s32 cache_block_count, s32 shard_cnt = 1) : shard_count(shard_cnt), base_storage(bs), block_size(bsz) {
                 /* Validate preconditions. */
                 AMS_ASSERT(buf_size >= static_cast<size_t>(this->block_size));
                 AMS_ASSERT(util::IsPowerOfTwo(this->block_size));
                 AMS_ASSERT(cache_block_count > 0);
                 AMS_ASSERT(buf_size >= static_cast<size_t>(this->block_size * cache_block_count));
+                AMS_ASSERT(0 < this->shard_count && this->shard_count <= MaxShardCount);
+
+                /* Every shard needs at least one block. */
+                this->shard_count = std::min(this->shard_count, cache_block_count);
 
                 /* Create a node for each cache block. */
                 for (auto i = 0; i < cache_block_count; i++) {
@@ -43,13 +57,15 @@ namespace ams::fssystem {
                     AMS_ASSERT(node != nullptr);
 
                     if (node != nullptr) {
-                        this->block_cache.PushMruNode(std::move(node), -1);
+                        this->shards[i % this->shard_count].block_cache.PushUnusedMruNode(std::move(node), -1);
                     }
                 }
             }
 
             ~ReadOnlyBlockCacheStorage() {
-                this->block_cache.DeleteAllNodes();
+                for (auto i = 0; i < this->shard_count; i++) {
+                    this->shards[i].block_cache.DeleteAllNodes();
+                }
             }
 
             virtual Result Read(s64 offset, void *buffer, size_t size) override {
@@ -58,12 +74,14 @@ namespace ams::fssystem {
                 AMS_ASSERT(util::IsAligned(size,   this->block_size));
 
                 if (size == static_cast<size_t>(this->block_size)) {
+                    const s64 block_index = offset / this->block_size;
+                    Shard &shard = this->shards[block_index % this->shard_count];
                     char *cached_buffer = nullptr;
 
                     /* Try to find a cached copy of the data. */
                     {
-                        std::scoped_lock lk(this->mutex);
-                        bool found = this->block_cache.FindValueAndUpdateMru(std::addressof(cached_buffer), offset / this->block_size);
+                        std::scoped_lock lk(shard.mutex);
+                        bool found = shard.block_cache.FindValueAndUpdateMru(std::addressof(cached_buffer), block_index);
                         if (found) {
                             std::memcpy(buffer, cached_buffer, size);
                             return ResultSuccess();
@@ -75,10 +93,10 @@ namespace ams::fssystem {
 
                     /* Add the block to the cache. */
                     {
-                        std::scoped_lock lk(this->mutex);
-                        auto lru = this->block_cache.PopLruNode();
+                        std::scoped_lock lk(shard.mutex);
+                        auto lru = shard.block_cache.PopLruNode();
                         std::memcpy(lru->value, buffer, this->block_size);
-                        this->block_cache.PushMruNode(std::move(lru), offset / this->block_size);
+                        shard.block_cache.PushMruNode(std::move(lru), block_index);
                     }
 
                     return ResultSuccess();
@@ -95,23 +113,27 @@ namespace ams::fssystem {
                 if (op_id == fs::OperationId::InvalidateCache) {
                     R_UNLESS(offset >= 0, fs::ResultInvalidOffset());
 
-                    std::scoped_lock lk(this->mutex);
-
-                    const size_t cache_block_count = this->block_cache.GetSize();
-                    BlockCache valid_cache;
-
-                    for (size_t count = 0; count < cache_block_count; ++count) {
-                        auto lru = this->block_cache.PopLruNode();
-                        if (offset <= lru->key && lru->key < offset + size) {
-                            this->block_cache.PushMruNode(std::move(lru), -1);
-                        } else {
-                            valid_cache.PushMruNode(std::move(lru), lru->key);
+                    for (auto i = 0; i < this->shard_count; i++) {
+                        Shard &shard = this->shards[i];
+                        std::scoped_lock lk(shard.mutex);
+
+                        const size_t cache_block_count = shard.block_cache.GetSize();
+                        BlockCache valid_cache;
+
+                        for (size_t count = 0; count < cache_block_count; ++count) {
+                            /* Blocks which are unused or invalidated are kept out of the hash table, and end up behind every valid block. */
+                            auto lru = shard.block_cache.PopLruNode();
+                            if (lru->key < 0 || (offset <= lru->key && lru->key < offset + size)) {
+                                shard.block_cache.PushUnusedMruNode(std::move(lru), -1);
+                            } else {
+                                valid_cache.PushMruNode(std::move(lru), lru->key);
+                            }
                         }
-                    }
 
-                    while (!valid_cache.IsEmpty()) {
-                        auto lru = valid_cache.PopLruNode();
-                        this->block_cache.PushMruNode(std::move(lru), lru->key);
+                        while (!valid_cache.IsEmpty()) {
+                            auto lru = valid_cache.PopLruNode();
+                            shard.block_cache.PushMruNode(std::move(lru), lru->key);
+                        }
                     }
                 }
 
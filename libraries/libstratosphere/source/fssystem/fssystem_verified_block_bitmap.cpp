@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+
+namespace ams::fssystem {
+
+    Result VerifiedBlockBitmap::Initialize(s64 count) {
+        AMS_ASSERT(!this->IsInitialized());
+        AMS_ASSERT(count >= 0);
+
+        /* Track as many blocks as we're allowed to. */
+        const s64 tracked_count = std::min(count, BlockCountMax);
+        const size_t word_count = util::DivideUp(static_cast<size_t>(tracked_count), BITSIZEOF(u64));
+        R_SUCCEED_IF(word_count == 0);
+
+        this->bitmap = fs::impl::MakeUnique<u64[]>(word_count);
+        R_UNLESS(this->bitmap != nullptr, fs::ResultAllocationFailureInMakeUnique());
+
+        std::memset(this->bitmap.get(), 0, word_count * sizeof(u64));
+        this->block_count = tracked_count;
+        return ResultSuccess();
+    }
+
+    void VerifiedBlockBitmap::Finalize() {
+        std::scoped_lock lk(this->mutex);
+
+        this->bitmap.reset();
+        this->block_count = 0;
+    }
+
+    bool VerifiedBlockBitmap::IsVerified(s64 block_index, s64 count) {
+        AMS_ASSERT(block_index >= 0);
+        AMS_ASSERT(count > 0);
+
+        /* Blocks we don't track are never considered verified. */
+        if (this->GetTrackedCount(block_index, count) != count) {
+            return false;
+        }
+
+        std::scoped_lock lk(this->mutex);
+
+        if (!this->IsInitialized()) {
+            return false;
+        }
+
+        for (s64 i = block_index; i < block_index + count; ++i) {
+            if (!this->GetBit(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void VerifiedBlockBitmap::SetVerified(s64 block_index, s64 count) {
+        AMS_ASSERT(block_index >= 0);
+
+        const s64 tracked_count = this->GetTrackedCount(block_index, count);
+        if (tracked_count == 0) {
+            return;
+        }
+
+        std::scoped_lock lk(this->mutex);
+
+        if (!this->IsInitialized()) {
+            return;
+        }
+
+        for (s64 i = block_index; i < block_index + tracked_count; ++i) {
+            this->bitmap[i / BITSIZEOF(u64)] |= (UINT64_C(1) << (i % BITSIZEOF(u64)));
+        }
+    }
+
+    void VerifiedBlockBitmap::Invalidate(s64 block_index, s64 count) {
+        AMS_ASSERT(block_index >= 0);
+
+        const s64 tracked_count = this->GetTrackedCount(block_index, count);
+        if (tracked_count == 0) {
+            return;
+        }
+
+        std::scoped_lock lk(this->mutex);
+
+        if (!this->IsInitialized()) {
+            return;
+        }
+
+        for (s64 i = block_index; i < block_index + tracked_count; ++i) {
+            this->bitmap[i / BITSIZEOF(u64)] &= ~(UINT64_C(1) << (i % BITSIZEOF(u64)));
+        }
+    }
+
+    void VerifiedBlockBitmap::InvalidateAll() {
+        std::scoped_lock lk(this->mutex);
+
+        if (this->IsInitialized()) {
+            std::memset(this->bitmap.get(), 0, util::DivideUp(static_cast<size_t>(this->block_count), BITSIZEOF(u64)) * sizeof(u64));
+        }
+    }
+
+}
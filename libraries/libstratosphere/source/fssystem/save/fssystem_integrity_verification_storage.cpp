@@ -60,12 +60,24 @@ namespace ams::fssystem::save {
 
     void IntegrityVerificationStorage::Finalize() {
         if (this->buffer_manager != nullptr) {
+            this->verified_bitmap.Finalize();
             this->hash_storage = fs::SubStorage();
             this->data_storage = fs::SubStorage();
             this->buffer_manager = nullptr;
         }
     }
 
+    Result IntegrityVerificationStorage::EnableVerifiedBlockBitmap() {
+        /* Validate preconditions. */
+        AMS_ASSERT(this->buffer_manager != nullptr);
+
+        /* Track every block of our data. */
+        s64 data_size;
+        R_TRY(this->data_storage.GetSize(std::addressof(data_size)));
+
+        return this->verified_bitmap.Initialize(util::DivideUp(data_size, this->verification_block_size));
+    }
+
     Result IntegrityVerificationStorage::Read(s64 offset, void *buffer, size_t size) {
         /* Although we support zero-size reads, we expect non-zero sizes. */
         AMS_ASSERT(size != 0);
@@ -109,6 +121,7 @@ namespace ams::fssystem::save {
             R_TRY(this->data_storage.Read(offset, buffer, read_size));
             clear_guard.Cancel();
         }
+        this->verified_bitmap.AddReadSize(read_size);
 
         /* Prepare to validate the signatures. */
         const auto signature_count = size >> this->verification_block_order;
@@ -120,8 +133,16 @@ namespace ams::fssystem::save {
 
         size_t verified_count = 0;
         while (verified_count < signature_count) {
+            const auto cur_count   = std::min(buffer_count, signature_count - verified_count);
+            const auto block_index = (offset >> this->verification_block_order) + static_cast<s64>(verified_count);
+
+            /* Skip blocks which we've already verified. */
+            if (this->verified_bitmap.IsVerified(block_index, cur_count)) {
+                verified_count += cur_count;
+                continue;
+            }
+
             /* Read the current signatures. */
-            const auto cur_count = std::min(buffer_count, signature_count - verified_count);
             auto cur_result = this->ReadBlockSignature(signature_buffer.GetBuffer(), signature_buffer.GetSize(), offset + (verified_count << this->verification_block_order), cur_count << this->verification_block_order);
 
             /* Temporarily increase our priority. */
@@ -143,6 +164,9 @@ namespace ams::fssystem::save {
                     }
 
                     cur_result = ResultSuccess();
+                } else if (R_SUCCEEDED(cur_result)) {
+                    /* Remember that the block is good. */
+                    this->verified_bitmap.SetVerified(block_index + i, 1);
                 }
             }
 
@@ -202,6 +226,12 @@ namespace ams::fssystem::save {
         /* Determine the size we're writing in blocks. */
         const auto aligned_write_size = util::AlignUp(write_size, this->verification_block_size);
 
+        /* The blocks we're writing will need to be verified again. */
+        const auto block_index = offset >> this->verification_block_order;
+        const auto block_count = static_cast<s64>(aligned_write_size >> this->verification_block_order);
+        this->verified_bitmap.Invalidate(block_index, block_count);
+        ON_SCOPE_EXIT { this->verified_bitmap.Invalidate(block_index, block_count); };
+
         /* Write the updated block signatures. */
         Result update_result = ResultSuccess();
         size_t updated_count = 0;
@@ -266,6 +296,9 @@ namespace ams::fssystem::save {
                     R_TRY(this->data_storage.GetSize(std::addressof(data_size)));
                     R_UNLESS(0 <= offset && offset <= data_size, fs::ResultInvalidOffset());
 
+                    /* The cleared blocks will need to be verified again. */
+                    this->verified_bitmap.Invalidate(offset >> this->verification_block_order, size >> this->verification_block_order);
+
                     /* Determine the extents to clear. */
                     const auto sign_offset = (offset >> this->verification_block_order) * HashSize;
                     const auto sign_size   = (std::min(size, data_size - offset) >> this->verification_block_order) * HashSize;
@@ -299,6 +332,9 @@ namespace ams::fssystem::save {
                     R_TRY(this->data_storage.GetSize(std::addressof(data_size)));
                     R_UNLESS(0 <= offset && offset <= data_size, fs::ResultInvalidOffset());
 
+                    /* The blocks will need to be verified again. */
+                    this->verified_bitmap.Invalidate(offset >> this->verification_block_order, size >> this->verification_block_order);
+
                     /* Determine the extents to clear the signature for. */
                     const auto sign_offset = (offset >> this->verification_block_order) * HashSize;
                     const auto sign_size   = (std::min(size, data_size - offset) >> this->verification_block_order) * HashSize;
@@ -329,6 +365,9 @@ namespace ams::fssystem::save {
                     R_TRY(this->data_storage.GetSize(std::addressof(data_size)));
                     R_UNLESS(0 <= offset && offset <= data_size, fs::ResultInvalidOffset());
 
+                    /* Forget which blocks we've verified. */
+                    this->verified_bitmap.Invalidate(offset >> this->verification_block_order, size >> this->verification_block_order);
+
                     /* Determine the extents to invalidate. */
                     const auto sign_offset = (offset >> this->verification_block_order) * HashSize;
                     const auto sign_size   = (std::min(size, data_size - offset) >> this->verification_block_order) * HashSize;
@@ -441,6 +480,7 @@ namespace ams::fssystem::save {
         }
 
         /* Get the calculated hash. */
+        this->verified_bitmap.AddHashedSize(this->verification_block_size);
         BlockHash calc_hash;
         this->CalcBlockHash(std::addressof(calc_hash), buf);
 
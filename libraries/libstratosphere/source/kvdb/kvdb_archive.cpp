@@ -22,6 +22,10 @@ namespace ams::kvdb {
         /* Convenience definitions. */
         constexpr u8 ArchiveHeaderMagic[4] = {'I', 'M', 'K', 'V'};
         constexpr u8 ArchiveEntryMagic[4]  = {'I', 'M', 'E', 'N'};
+        constexpr u8 JournalHeaderMagic[4] = {'I', 'M', 'J', 'H'};
+        constexpr u8 JournalRecordMagic[4] = {'I', 'M', 'J', 'N'};
+
+        constexpr size_t JournalArchiveHashSize = crypto::Sha256Generator::HashSize;
 
         /* Archive types. */
         struct ArchiveHeader {
@@ -63,6 +67,73 @@ namespace ams::kvdb {
         };
         static_assert(sizeof(ArchiveEntryHeader) == 0xC && util::is_pod<ArchiveEntryHeader>::value, "ArchiveEntryHeader definition!");
 
+        /* Journal types. */
+        struct JournalHeader {
+            u8 magic[sizeof(JournalHeaderMagic)];
+            u32 pad;
+            u8 archive_hash[JournalArchiveHashSize];
+
+            Result Validate() const {
+                R_UNLESS(std::memcmp(this->magic, JournalHeaderMagic, sizeof(JournalHeaderMagic)) == 0, ResultInvalidKeyValue());
+                return ResultSuccess();
+            }
+
+            static JournalHeader Make(const void *archive_hash, size_t hash_size) {
+                AMS_ABORT_UNLESS(hash_size == JournalArchiveHashSize);
+
+                JournalHeader header = {};
+                std::memcpy(header.magic, JournalHeaderMagic, sizeof(JournalHeaderMagic));
+                std::memcpy(header.archive_hash, archive_hash, hash_size);
+                return header;
+            }
+        };
+        static_assert(sizeof(JournalHeader) == 0x28 && util::is_pod<JournalHeader>::value, "JournalHeader definition!");
+
+        struct JournalRecordHeader {
+            u8 magic[sizeof(JournalRecordMagic)];
+            u32 type;
+            u32 key_size;
+            u32 value_size;
+            u32 checksum;
+
+            Result Validate() const {
+                R_UNLESS(std::memcmp(this->magic, JournalRecordMagic, sizeof(JournalRecordMagic)) == 0, ResultInvalidKeyValue());
+                R_UNLESS(this->type == JournalRecordType_Set || this->type == JournalRecordType_Remove, ResultInvalidKeyValue());
+                R_UNLESS(this->type == JournalRecordType_Set || this->value_size == 0,                  ResultInvalidKeyValue());
+                return ResultSuccess();
+            }
+
+            static JournalRecordHeader Make(JournalRecordType type, size_t ksz, size_t vsz) {
+                JournalRecordHeader header = {};
+                std::memcpy(header.magic, JournalRecordMagic, sizeof(JournalRecordMagic));
+                header.type = type;
+                header.key_size = ksz;
+                header.value_size = vsz;
+                return header;
+            }
+        };
+        static_assert(sizeof(JournalRecordHeader) == 0x14 && util::is_pod<JournalRecordHeader>::value, "JournalRecordHeader definition!");
+
+        u32 CalculateJournalRecordChecksum(const JournalRecordHeader &header, const void *key, size_t key_size, const void *value, size_t value_size) {
+            /* The checksum covers the header (with the checksum field cleared), the key, and the value. */
+            JournalRecordHeader tmp_header = header;
+            tmp_header.checksum = 0;
+
+            crypto::Sha256Generator generator;
+            generator.Initialize();
+            generator.Update(&tmp_header, sizeof(tmp_header));
+            generator.Update(key, key_size);
+            generator.Update(value, value_size);
+
+            u8 hash[crypto::Sha256Generator::HashSize];
+            generator.GetHash(hash, sizeof(hash));
+
+            /* Use the first four bytes of the hash as the checksum. */
+            u32 checksum;
+            std::memcpy(&checksum, hash, sizeof(checksum));
+            return checksum;
+        }
+
     }
 
     /* Reader functionality. */
@@ -164,4 +235,111 @@ namespace ams::kvdb {
         this->size += sizeof(ArchiveEntryHeader) + key_size + value_size;
     }
 
-}
\ No newline at end of file
+    /* Journal reader functionality. */
+    Result JournalReader::Peek(void *dst, size_t size) {
+        /* Bounds check. */
+        R_UNLESS(this->offset + size <= this->buffer.GetSize(), ResultInvalidKeyValue());
+        R_UNLESS(this->offset < this->offset + size,            ResultInvalidKeyValue());
+
+        std::memcpy(dst, this->buffer.Get() + this->offset, size);
+        return ResultSuccess();
+    }
+
+    Result JournalReader::Read(void *dst, size_t size) {
+        R_TRY(this->Peek(dst, size));
+        this->offset += size;
+        return ResultSuccess();
+    }
+
+    Result JournalReader::ReadHeader(void *out_archive_hash, size_t hash_size) {
+        /* This should only be called at the start of reading stream. */
+        AMS_ABORT_UNLESS(this->offset == 0);
+        AMS_ABORT_UNLESS(hash_size == JournalArchiveHashSize);
+
+        /* Read and validate header. */
+        JournalHeader header;
+        R_TRY(this->Read(&header, sizeof(header)));
+        R_TRY(header.Validate());
+
+        std::memcpy(out_archive_hash, header.archive_hash, hash_size);
+        return ResultSuccess();
+    }
+
+    Result JournalReader::GetRecordInfo(JournalRecordType *out_type, size_t *out_key_size, size_t *out_value_size) {
+        /* Peek the next record header. */
+        JournalRecordHeader header;
+        R_TRY(this->Peek(&header, sizeof(header)));
+        R_TRY(header.Validate());
+
+        /* Check that the whole record is present. */
+        const size_t record_size = sizeof(header) + header.key_size + header.value_size;
+        R_UNLESS(this->offset + record_size <= this->buffer.GetSize(), ResultInvalidKeyValue());
+        R_UNLESS(this->offset < this->offset + record_size,            ResultInvalidKeyValue());
+
+        /* Check that the record wasn't torn or corrupted. */
+        const u8 *key   = this->buffer.Get() + this->offset + sizeof(header);
+        const u8 *value = key + header.key_size;
+        R_UNLESS(header.checksum == CalculateJournalRecordChecksum(header, key, header.key_size, value, header.value_size), ResultInvalidKeyValue());
+
+        *out_type = static_cast<JournalRecordType>(header.type);
+        *out_key_size = header.key_size;
+        *out_value_size = header.value_size;
+        return ResultSuccess();
+    }
+
+    Result JournalReader::ReadRecord(void *out_key, size_t key_size, void *out_value, size_t value_size) {
+        /* Read the next record header. */
+        JournalRecordHeader header;
+        R_TRY(this->Read(&header, sizeof(header)));
+        R_TRY(header.Validate());
+
+        /* Key size and Value size must be correct. */
+        AMS_ABORT_UNLESS(key_size == header.key_size);
+        AMS_ABORT_UNLESS(value_size == header.value_size);
+
+        R_ABORT_UNLESS(this->Read(out_key, key_size));
+        if (value_size > 0) {
+            R_ABORT_UNLESS(this->Read(out_value, value_size));
+        }
+        return ResultSuccess();
+    }
+
+    /* Journal writer functionality. */
+    Result JournalWriter::Write(const void *src, size_t size) {
+        /* Bounds check. */
+        R_UNLESS(this->offset + size <= this->buffer.GetSize(), ResultInvalidKeyValue());
+        R_UNLESS(this->offset < this->offset + size,            ResultInvalidKeyValue());
+
+        std::memcpy(this->buffer.Get() + this->offset, src, size);
+        this->offset += size;
+        return ResultSuccess();
+    }
+
+    void JournalWriter::WriteHeader(const void *archive_hash, size_t hash_size) {
+        /* This should only be called at start of write. */
+        AMS_ABORT_UNLESS(this->offset == 0);
+
+        JournalHeader header = JournalHeader::Make(archive_hash, hash_size);
+        R_ABORT_UNLESS(this->Write(&header, sizeof(header)));
+    }
+
+    void JournalWriter::WriteRecord(JournalRecordType type, const void *key, size_t key_size, const void *value, size_t value_size) {
+        JournalRecordHeader header = JournalRecordHeader::Make(type, key_size, value_size);
+        header.checksum = CalculateJournalRecordChecksum(header, key, key_size, value, value_size);
+        R_ABORT_UNLESS(this->Write(&header, sizeof(header)));
+        R_ABORT_UNLESS(this->Write(key, key_size));
+        if (value_size > 0) {
+            R_ABORT_UNLESS(this->Write(value, value_size));
+        }
+    }
+
+    /* Journal size helper functionality. */
+    void JournalSizeHelper::AddHeader() {
+        this->size += sizeof(JournalHeader);
+    }
+
+    void JournalSizeHelper::AddRecord(size_t key_size, size_t value_size) {
+        this->size += sizeof(JournalRecordHeader) + key_size + value_size;
+    }
+
+}
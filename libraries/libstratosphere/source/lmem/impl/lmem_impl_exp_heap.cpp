@@ -18,6 +18,25 @@
 
 namespace ams::lmem::impl {
 
+    /* Segregated fit keeps free blocks in lists by size class, in addition to the address-ordered free list. */
+    /* The list nodes live in the free blocks' memory, so only blocks with room for one are classed. */
+    struct ExpHeapFreeBinTable {
+        struct Node {
+            Node *prev;
+            Node *next;
+        };
+
+        static constexpr size_t BinCount        = BITSIZEOF(u64);
+        static constexpr size_t SubdivisionBits = 1;
+        static constexpr size_t MinimumSizeBits = 4;
+        static constexpr size_t MinimumSize     = static_cast<size_t>(1) << MinimumSizeBits;
+        static_assert(sizeof(Node) <= MinimumSize);
+
+        u64 non_empty_bins;
+        size_t total_free_size;
+        Node *bins[BinCount];
+    };
+
     namespace {
 
         constexpr u16 FreeBlockMagic = 0x4652; /* FR */
@@ -146,6 +165,99 @@ namespace ams::lmem::impl {
             head->mode = mode;
         }
 
+        constexpr inline size_t GetMostSignificantBit(size_t size) {
+            return BITSIZEOF(size) - 1 - util::CountLeadingZeros(size);
+        }
+
+        constexpr inline size_t GetFreeBinIndex(size_t size) {
+            /* Sizes are classed by their most significant bit, and the bits just below it. */
+            const size_t msb = GetMostSignificantBit(size);
+            const size_t sub = (size >> (msb - ExpHeapFreeBinTable::SubdivisionBits)) & ((static_cast<size_t>(1) << ExpHeapFreeBinTable::SubdivisionBits) - 1);
+            return ((msb - ExpHeapFreeBinTable::MinimumSizeBits) << ExpHeapFreeBinTable::SubdivisionBits) + sub;
+        }
+
+        inline ExpHeapFreeBinTable::Node *GetFreeBinNode(ExpHeapMemoryBlockHead *block) {
+            return reinterpret_cast<ExpHeapFreeBinTable::Node *>(GetMemoryBlockStart(block));
+        }
+
+        void AddToFreeBins(ExpHeapFreeBinTable *table, ExpHeapMemoryBlockHead *block) {
+            table->total_free_size += block->block_size;
+
+            if (block->block_size < ExpHeapFreeBinTable::MinimumSize) {
+                return;
+            }
+
+            const size_t index = std::min(GetFreeBinIndex(block->block_size), ExpHeapFreeBinTable::BinCount - 1);
+            ExpHeapFreeBinTable::Node *node = GetFreeBinNode(block);
+
+            node->prev = nullptr;
+            node->next = table->bins[index];
+            if (node->next != nullptr) {
+                node->next->prev = node;
+            }
+
+            table->bins[index] = node;
+            table->non_empty_bins |= (UINT64_C(1) << index);
+        }
+
+        void RemoveFromFreeBins(ExpHeapFreeBinTable *table, ExpHeapMemoryBlockHead *block) {
+            table->total_free_size -= block->block_size;
+
+            if (block->block_size < ExpHeapFreeBinTable::MinimumSize) {
+                return;
+            }
+
+            const size_t index = std::min(GetFreeBinIndex(block->block_size), ExpHeapFreeBinTable::BinCount - 1);
+            ExpHeapFreeBinTable::Node *node = GetFreeBinNode(block);
+
+            if (node->prev != nullptr) {
+                node->prev->next = node->next;
+            } else {
+                table->bins[index] = node->next;
+            }
+            if (node->next != nullptr) {
+                node->next->prev = node->prev;
+            }
+
+            if (table->bins[index] == nullptr) {
+                table->non_empty_bins &= ~(UINT64_C(1) << index);
+            }
+        }
+
+        ExpHeapMemoryBlockHead *FindFreeBinBlock(const ExpHeapFreeBinTable *table, size_t size, s32 alignment) {
+            /* Ask for enough that the allocation fits wherever the alignment places it within the block. */
+            size_t required_size = std::max(size + (alignment - MinimumAlignment), ExpHeapFreeBinTable::MinimumSize);
+
+            /* Round up to the next class boundary, so that any block in the classes we search will fit. */
+            required_size += (static_cast<size_t>(1) << (GetMostSignificantBit(required_size) - ExpHeapFreeBinTable::SubdivisionBits)) - 1;
+
+            const size_t index = GetFreeBinIndex(required_size);
+            if (index >= ExpHeapFreeBinTable::BinCount) {
+                return nullptr;
+            }
+
+            const u64 candidates = table->non_empty_bins & (~UINT64_C(0) << index);
+            if (candidates == 0) {
+                return nullptr;
+            }
+
+            return GetHeadForMemoryBlock(table->bins[__builtin_ctzll(candidates)]);
+        }
+
+        inline ExpHeapMemoryBlockList::iterator InsertFreeBlock(ExpHeapHead *head, ExpHeapMemoryBlockList::const_iterator pos, ExpHeapMemoryBlockHead *block) {
+            if (head->free_bins != nullptr) {
+                AddToFreeBins(head->free_bins, block);
+            }
+            return head->free_list.insert(pos, *block);
+        }
+
+        inline ExpHeapMemoryBlockList::iterator EraseFreeBlock(ExpHeapHead *head, ExpHeapMemoryBlockList::const_iterator it) {
+            if (head->free_bins != nullptr) {
+                RemoveFromFreeBins(head->free_bins, const_cast<ExpHeapMemoryBlockHead *>(std::addressof(*it)));
+            }
+            return head->free_list.erase(it);
+        }
+
         inline ExpHeapMemoryBlockHead *InitializeMemoryBlock(const MemoryRegion &region, u16 magic) {
             ExpHeapMemoryBlockHead *block = reinterpret_cast<ExpHeapMemoryBlockHead *>(region.start);
 
@@ -181,6 +293,7 @@ namespace ams::lmem::impl {
             /* Set exp heap fields. */
             exp_heap_head->group_id = DefaultGroupId;
             exp_heap_head->use_alignment_margins = false;
+            exp_heap_head->free_bins = nullptr;
             SetAllocationModeImpl(exp_heap_head, DefaultAllocationMode);
 
             /* Initialize memory block. */
@@ -208,7 +321,7 @@ namespace ams::lmem::impl {
                 /* Coalesce block after, if possible. */
                 if (cur_free_block == region->end) {
                     free_region.end = GetMemoryBlockEnd(cur_free_block);
-                    it = head->free_list.erase(it);
+                    it = EraseFreeBlock(head, it);
 
                     /* Fill the memory with a pattern, for debug. */
                     FillUnallocatedMemory(GetHeapHead(head), cur_free_block, sizeof(ExpHeapMemoryBlockHead));
@@ -224,7 +337,7 @@ namespace ams::lmem::impl {
                 if (GetMemoryBlockEnd(&*prev_free_block_it) == region->start) {
                     /* We can coalesce, so do so. */
                     free_region.start = &*prev_free_block_it;
-                    insertion_it = head->free_list.erase(prev_free_block_it);
+                    insertion_it = EraseFreeBlock(head, prev_free_block_it);
                 } else {
                     /* We can't coalesce, so just select the next iterator. */
                     insertion_it = (++prev_free_block_it);
@@ -242,7 +355,7 @@ namespace ams::lmem::impl {
             FillFreedMemory(GetHeapHead(head), free_region.start, GetPointerDifference(free_region.start, free_region.end));
 
             /* Insert the new memory block. */
-            head->free_list.insert(insertion_it, *InitializeFreeMemoryBlock(free_region));
+            InsertFreeBlock(head, insertion_it, InitializeFreeMemoryBlock(free_region));
 
             return true;
         }
@@ -257,7 +370,7 @@ namespace ams::lmem::impl {
             free_region_front.end = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(block) - sizeof(ExpHeapMemoryBlockHead));
 
             /* Remove the old block. */
-            auto old_block_it = head->free_list.erase(head->free_list.iterator_to(*block_head));
+            auto old_block_it = EraseFreeBlock(head, head->free_list.iterator_to(*block_head));
 
             /* If the front margins are big enough (and we're allowed to do so), make a new block. */
             if ((GetPointerDifference(free_region_front.start, free_region_front.end) < sizeof(ExpHeapMemoryBlockHead) + MinimumFreeBlockSize) ||
@@ -266,7 +379,7 @@ namespace ams::lmem::impl {
                 free_region_front.end = free_region_front.start;
             } else {
                 /* Make a new block! */
-                head->free_list.insert(old_block_it, *InitializeFreeMemoryBlock(free_region_front));
+                InsertFreeBlock(head, old_block_it, InitializeFreeMemoryBlock(free_region_front));
             }
 
             /* If the back margins are big enough (and we're allowed to do so), make a new block. */
@@ -276,7 +389,7 @@ namespace ams::lmem::impl {
                 free_region_back.end = free_region_back.start;
             } else {
                 /* Make a new block! */
-                head->free_list.insert(old_block_it, *InitializeFreeMemoryBlock(free_region_back));
+                InsertFreeBlock(head, old_block_it, InitializeFreeMemoryBlock(free_region_back));
             }
 
             /* Fill the memory with a pattern, for debug. */
@@ -301,25 +414,36 @@ namespace ams::lmem::impl {
         void *AllocateFromHead(HeapHead *heap, size_t size, s32 alignment) {
             ExpHeapHead *exp_heap_head = GetExpHeapHead(heap);
 
-            const bool is_first_fit = GetAllocationModeImpl(exp_heap_head) == AllocationMode_FirstFit;
+            const AllocationMode mode = GetAllocationModeImpl(exp_heap_head);
+            const bool is_first_fit   = mode != AllocationMode_BestFit;
 
             /* Choose a block. */
             ExpHeapMemoryBlockHead *found_block_head = nullptr;
             void *found_block = nullptr;
             size_t best_size = std::numeric_limits<size_t>::max();
 
-            for (auto it = exp_heap_head->free_list.begin(); it != exp_heap_head->free_list.end(); it++) {
-                const uintptr_t absolute_block_start = reinterpret_cast<uintptr_t>(GetMemoryBlockStart(&*it));
-                const uintptr_t block_start          = util::AlignUp(absolute_block_start, alignment);
-                const size_t    block_offset         = block_start - absolute_block_start;
-
-                if (it->block_size >= size + block_offset && best_size > it->block_size) {
-                    found_block_head = &*it;
-                    found_block      = reinterpret_cast<void *>(block_start);
-                    best_size        = it->block_size;
+            /* If we're using segregated fit, try to take a block by size class. */
+            if (mode == AllocationMode_SegregatedFit && exp_heap_head->free_bins != nullptr) {
+                if ((found_block_head = FindFreeBinBlock(exp_heap_head->free_bins, size, alignment)) != nullptr) {
+                    found_block = reinterpret_cast<void *>(util::AlignUp(reinterpret_cast<uintptr_t>(GetMemoryBlockStart(found_block_head)), alignment));
+                }
+            }
 
-                    if (is_first_fit || best_size == size) {
-                        break;
+            /* Otherwise, search the free list. Segregated fit searches first fit, so that it never fails where first fit would succeed. */
+            if (found_block_head == nullptr) {
+                for (auto it = exp_heap_head->free_list.begin(); it != exp_heap_head->free_list.end(); it++) {
+                    const uintptr_t absolute_block_start = reinterpret_cast<uintptr_t>(GetMemoryBlockStart(&*it));
+                    const uintptr_t block_start          = util::AlignUp(absolute_block_start, alignment);
+                    const size_t    block_offset         = block_start - absolute_block_start;
+
+                    if (it->block_size >= size + block_offset && best_size > it->block_size) {
+                        found_block_head = &*it;
+                        found_block      = reinterpret_cast<void *>(block_start);
+                        best_size        = it->block_size;
+
+                        if (is_first_fit || best_size == size) {
+                            break;
+                        }
                     }
                 }
             }
@@ -335,13 +459,16 @@ namespace ams::lmem::impl {
         void *AllocateFromTail(HeapHead *heap, size_t size, s32 alignment) {
             ExpHeapHead *exp_heap_head = GetExpHeapHead(heap);
 
-            const bool is_first_fit = GetAllocationModeImpl(exp_heap_head) == AllocationMode_FirstFit;
+            const AllocationMode mode = GetAllocationModeImpl(exp_heap_head);
+            const bool is_first_fit   = mode != AllocationMode_BestFit;
 
             /* Choose a block. */
             ExpHeapMemoryBlockHead *found_block_head = nullptr;
             void *found_block = nullptr;
             size_t best_size = std::numeric_limits<size_t>::max();
 
+            /* Search the free list from the back. Segregated fit doesn't use its size classes here, since they aren't address-ordered, */
+            /* and tail allocations must take the highest block that fits; it searches first fit instead. */
             for (auto it = exp_heap_head->free_list.rbegin(); it != exp_heap_head->free_list.rend(); it++) {
                 const uintptr_t absolute_block_start = reinterpret_cast<uintptr_t>(GetMemoryBlockStart(&*it));
                 const uintptr_t block_start          = util::AlignUp(absolute_block_start, alignment);
@@ -366,6 +493,47 @@ namespace ams::lmem::impl {
             return ConvertFreeBlockToUsedBlock(exp_heap_head, found_block_head, found_block, size, AllocationDirection_Back);
         }
 
+        void EnableFreeBins(HeapHead *heap) {
+            ExpHeapHead *exp_heap_head = GetExpHeapHead(heap);
+
+            /* Allocate the table from the heap itself. If we can't, allocation will just fall back to first fit. */
+            void *table_memory = AllocateFromTail(heap, util::AlignUp(sizeof(ExpHeapFreeBinTable), MinimumAlignment), alignof(ExpHeapFreeBinTable));
+            if (table_memory == nullptr) {
+                return;
+            }
+
+            /* Keep the table's block off the used list, so that it isn't visited as an allocation. */
+            exp_heap_head->used_list.erase(exp_heap_head->used_list.iterator_to(*GetHeadForMemoryBlock(table_memory)));
+
+            /* Class all current free blocks. */
+            ExpHeapFreeBinTable *table = new (table_memory) ExpHeapFreeBinTable;
+            table->non_empty_bins  = 0;
+            table->total_free_size = 0;
+            std::fill(std::begin(table->bins), std::end(table->bins), nullptr);
+
+            for (auto &block : exp_heap_head->free_list) {
+                AddToFreeBins(table, std::addressof(block));
+            }
+
+            exp_heap_head->free_bins = table;
+        }
+
+        void DisableFreeBins(HeapHead *heap) {
+            ExpHeapHead *exp_heap_head = GetExpHeapHead(heap);
+
+            ExpHeapFreeBinTable *table = exp_heap_head->free_bins;
+            if (table == nullptr) {
+                return;
+            }
+
+            /* Stop maintaining the table, and return its memory to the heap. */
+            exp_heap_head->free_bins = nullptr;
+
+            MemoryRegion region;
+            GetMemoryBlockRegion(std::addressof(region), GetHeadForMemoryBlock(table));
+            AMS_ASSERT(CoalesceFreedRegion(exp_heap_head, std::addressof(region)));
+        }
+
     }
 
     HeapHandle CreateExpHeap(void *address, size_t size, u32 option) {
@@ -407,7 +575,7 @@ namespace ams::lmem::impl {
         }
 
         /* Remove the memory block. */
-        exp_heap_head->free_list.pop_back();
+        EraseFreeBlock(exp_heap_head, exp_heap_head->free_list.iterator_to(*block));
 
         const size_t freed_size = block_size + sizeof(ExpHeapMemoryBlockHead);
         heap_head->heap_end = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(heap_head->heap_end) - freed_size);
@@ -507,7 +675,7 @@ namespace ams::lmem::impl {
                 GetMemoryBlockRegion(&new_free_region, next_block_head);
 
                 /* Remove the next block from the free list. */
-                auto insertion_it = exp_heap_head->free_list.erase(exp_heap_head->free_list.iterator_to(*next_block_head));
+                auto insertion_it = EraseFreeBlock(exp_heap_head, exp_heap_head->free_list.iterator_to(*next_block_head));
 
                 /* Figure out the new block extents. */
                 void *old_start = new_free_region.start;
@@ -523,7 +691,7 @@ namespace ams::lmem::impl {
                 /* Adjust block sizes. */
                 block_head->block_size = GetPointerDifference(mem_block, new_free_region.start);
                 if (GetPointerDifference(new_free_region.start, new_free_region.end) >= sizeof(ExpHeapMemoryBlockHead) + MinimumFreeBlockSize) {
-                    exp_heap_head->free_list.insert(insertion_it, *InitializeFreeMemoryBlock(new_free_region));
+                    InsertFreeBlock(exp_heap_head, insertion_it, InitializeFreeMemoryBlock(new_free_region));
                 }
 
                 /* Fill the memory with a pattern, for debug. */
@@ -547,6 +715,11 @@ namespace ams::lmem::impl {
     size_t GetExpHeapTotalFreeSize(HeapHandle handle) {
         AMS_ASSERT(IsValidHeapHandle(handle));
 
+        /* If we're tracking free blocks by size class, we already know the total. */
+        if (const ExpHeapFreeBinTable *table = GetExpHeapHead(handle)->free_bins; table != nullptr) {
+            return table->total_free_size;
+        }
+
         size_t total_size = 0;
         for (const auto &it : GetExpHeapHead(handle)->free_list) {
             total_size += it.block_size;
@@ -592,6 +765,14 @@ namespace ams::lmem::impl {
 
         ExpHeapHead *exp_heap_head = GetExpHeapHead(handle);
         const AllocationMode old_mode = GetAllocationModeImpl(exp_heap_head);
+
+        /* Segregated fit needs free blocks to be classed by size, which we only maintain while it's in use. */
+        if (new_mode == AllocationMode_SegregatedFit && old_mode != AllocationMode_SegregatedFit) {
+            EnableFreeBins(handle);
+        } else if (new_mode != AllocationMode_SegregatedFit && old_mode == AllocationMode_SegregatedFit) {
+            DisableFreeBins(handle);
+        }
+
         SetAllocationModeImpl(exp_heap_head, new_mode);
         return old_mode;
     }
@@ -32,6 +32,9 @@ namespace ams::ncm {
         ContentMetaMemoryResource g_gamecard_content_meta_memory_resource(g_gamecard_content_meta_database_heap, sizeof(g_gamecard_content_meta_database_heap));
         ContentMetaMemoryResource g_sd_and_user_content_meta_memory_resource(g_sd_and_user_content_meta_database_heap, sizeof(g_sd_and_user_content_meta_database_heap));
 
+        /* Content meta database saves append to a journal, and only rewrite the archive once the journal would exceed this. */
+        constexpr size_t ContentMetaDatabaseJournalSizeMax = 16_KB;
+
         constexpr fs::SystemSaveDataId BuiltInSystemSaveDataId = 0x8000000000000120;
         constexpr u64 BuiltInSystemSaveDataSize                = 0x6c000;
         constexpr u64 BuiltInSystemSaveDataJournalSize         = 0x6c000;
@@ -627,8 +630,15 @@ namespace ams::ncm {
 
             /* Initialize and load the key value store from the filesystem. */
             R_TRY(root->kvs->Initialize(root->path, root->max_content_metas, root->memory_resource));
+            root->kvs->EnableJournal(ContentMetaDatabaseJournalSizeMax);
             R_TRY(root->kvs->Load());
 
+            /* Nintendo's ncm only reads the archive, so fold any journal left over from a previous boot back into it. */
+            /* NOTE: This is best-effort, as the journal remains usable by us if it fails. */
+            if (root->kvs->HasJournal() && R_SUCCEEDED(root->kvs->CompactJournal())) {
+                fs::CommitSaveData(root->mount_name);
+            }
+
             /* Create the content meta database. */
             root->content_meta_database = sf::CreateSharedObjectEmplaced<IContentMetaDatabase, ContentMetaDatabaseImpl>(std::addressof(*root->kvs), root->mount_name);
             mount_guard.Cancel();
@@ -646,6 +656,11 @@ namespace ams::ncm {
 
         /* Disable the content meta database, if present. */
         if (root->content_meta_database != nullptr) {
+            /* Fold any journal back into the archive before we stop using it, as with activation. */
+            if (storage_id != StorageId::GameCard && root->kvs->HasJournal() && R_SUCCEEDED(root->kvs->CompactJournal())) {
+                fs::CommitSaveData(root->mount_name);
+            }
+
             /* N doesn't bother checking the result of this */
             root->content_meta_database->DisableForcibly();
             root->content_meta_database = nullptr;
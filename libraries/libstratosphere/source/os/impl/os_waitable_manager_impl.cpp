@@ -22,6 +22,7 @@ namespace ams::os::impl {
 
     Result WaitableManagerImpl::WaitAnyImpl(WaitableHolderBase **out, bool infinite, TimeSpan timeout, bool reply, Handle reply_target) {
         /* Prepare for processing. */
+        this->wait_count++;
         this->signaled_holder = nullptr;
         this->target_impl.SetCurrentThreadHandleForCancelWait();
         WaitableHolderBase *holder = this->LinkHoldersToObjectList();
@@ -60,10 +61,10 @@ namespace ams::os::impl {
     }
 
     Result WaitableManagerImpl::WaitAnyHandleImpl(WaitableHolderBase **out, bool infinite, TimeSpan timeout, bool reply, Handle reply_target) {
-        Handle object_handles[MaximumHandleCount];
-        WaitableHolderBase *objects[MaximumHandleCount];
+        Handle * const object_handles     = this->object_handles;
+        WaitableHolderBase ** const objects = this->objects;
 
-        const s32 count = this->BuildHandleArray(object_handles, objects, MaximumHandleCount);
+        const s32 count = this->object_count;
         const TimeSpan end_time = infinite ? TimeSpan::FromNanoSeconds(std::numeric_limits<s64>::max()) : GetCurrentTick().ToTimeSpan() + timeout;
 
         while (true) {
@@ -135,52 +136,105 @@ namespace ams::os::impl {
         }
     }
 
-    s32 WaitableManagerImpl::BuildHandleArray(Handle out_handles[], WaitableHolderBase *out_objects[], s32 num) {
+    void WaitableManagerImpl::AddToArrays(WaitableHolderBase &holder_base) {
+        if (const Handle handle = holder_base.GetHandle(); handle != svc::InvalidHandle) {
+            AMS_ABORT_UNLESS(this->object_count < static_cast<s32>(MaximumHandleCount));
+
+            this->object_handles[this->object_count] = handle;
+            this->objects[this->object_count]        = std::addressof(holder_base);
+            this->object_count++;
+        } else {
+            /* If we have too many user objects to track, we'll fall back to walking the list until some are unlinked. */
+            if (this->user_object_count < static_cast<s32>(MaximumUserObjectCount)) {
+                this->user_objects[this->user_object_count] = std::addressof(holder_base);
+            }
+            this->user_object_count++;
+        }
+
+        this->update_count++;
+    }
+
+    void WaitableManagerImpl::RemoveFromArrays(WaitableHolderBase &holder_base) {
+        /* Remove the holder from the handle array, preserving the order of the remaining holders. */
+        for (s32 i = 0; i < this->object_count; i++) {
+            if (this->objects[i] == std::addressof(holder_base)) {
+                for (s32 j = i + 1; j < this->object_count; j++) {
+                    this->object_handles[j - 1] = this->object_handles[j];
+                    this->objects[j - 1]        = this->objects[j];
+                }
+                this->object_count--;
+                this->update_count++;
+                return;
+            }
+        }
+
+        /* The holder wasn't in the handle array, so it must be a user object. */
+        AMS_ABORT_UNLESS(this->user_object_count > 0);
+        if (this->IsUserObjectArrayValid()) {
+            for (s32 i = 0; i < this->user_object_count; i++) {
+                if (this->user_objects[i] == std::addressof(holder_base)) {
+                    for (s32 j = i + 1; j < this->user_object_count; j++) {
+                        this->user_objects[j - 1] = this->user_objects[j];
+                    }
+                    break;
+                }
+            }
+            this->user_object_count--;
+        } else {
+            this->user_object_count--;
+            if (this->IsUserObjectArrayValid()) {
+                this->RebuildUserObjectArray();
+            }
+        }
+
+        this->update_count++;
+    }
+
+    void WaitableManagerImpl::RebuildUserObjectArray() {
         s32 count = 0;
 
         for (WaitableHolderBase &holder_base : this->waitable_list) {
-            if (Handle handle = holder_base.GetHandle(); handle != svc::InvalidHandle) {
-                AMS_ASSERT(count < num);
-
-                out_handles[count] = handle;
-                out_objects[count] = &holder_base;
-                count++;
+            if (holder_base.GetHandle() == svc::InvalidHandle) {
+                AMS_ABORT_UNLESS(count < static_cast<s32>(MaximumUserObjectCount));
+                this->user_objects[count++] = std::addressof(holder_base);
             }
         }
 
-        return count;
+        AMS_ABORT_UNLESS(count == this->user_object_count);
     }
 
     WaitableHolderBase *WaitableManagerImpl::LinkHoldersToObjectList() {
         WaitableHolderBase *signaled_holder = nullptr;
 
-        for (WaitableHolderBase &holder_base : this->waitable_list) {
+        /* Only user objects have object lists, and they're kept in list order, so the first signaled holder is unchanged. */
+        this->ForEachUserObject([&](WaitableHolderBase &holder_base) {
             TriBool is_signaled = holder_base.LinkToObjectList();
 
             if (signaled_holder == nullptr && is_signaled == TriBool::True) {
                 signaled_holder = &holder_base;
             }
-        }
+        });
 
         return signaled_holder;
     }
 
     void WaitableManagerImpl::UnlinkHoldersFromObjectList() {
-        for (WaitableHolderBase &holder_base : this->waitable_list) {
+        this->ForEachUserObject([](WaitableHolderBase &holder_base) {
             holder_base.UnlinkFromObjectList();
-        }
+        });
     }
 
     WaitableHolderBase *WaitableManagerImpl::RecalculateNextTimeout(TimeSpan *out_min_timeout, TimeSpan end_time) {
         WaitableHolderBase *min_timeout_holder = nullptr;
         TimeSpan min_time = end_time;
 
-        for (WaitableHolderBase &holder_base : this->waitable_list) {
+        /* Only user objects (timer events) can have a wakeup time. */
+        this->ForEachUserObject([&](WaitableHolderBase &holder_base) {
             if (const TimeSpan cur_time = holder_base.GetAbsoluteWakeupTime(); cur_time < min_time) {
                 min_timeout_holder = &holder_base;
                 min_time = cur_time;
             }
-        }
+        });
 
         if (min_time < this->current_time) {
             *out_min_timeout = 0;
@@ -30,17 +30,48 @@ namespace ams::os::impl {
             static constexpr s32 WaitInvalid   = -3;
             static constexpr s32 WaitCancelled = -2;
             static constexpr s32 WaitTimedOut  = -1;
+            static constexpr size_t MaximumUserObjectCount = WaitableManagerUserObjectCountMax;
             using ListType = util::IntrusiveListMemberTraits<&WaitableHolderBase::manager_node>::ListType;
         private:
             ListType waitable_list;
             WaitableHolderBase *signaled_holder;
             TimeSpan current_time;
+            /* The handle array is kept in sync with the list as holders are linked and unlinked, rather than built on every wait. */
+            WaitableHolderBase *objects[MaximumHandleCount];
+            /* User objects are tracked separately, so that waits needn't walk holders which never need linking or have no timeout. */
+            WaitableHolderBase *user_objects[MaximumUserObjectCount];
+            u64 wait_count;
+            u64 update_count;
+            Handle object_handles[MaximumHandleCount];
+            s32 object_count;
+            s32 user_object_count;
             InternalCriticalSection cs_wait;
             WaitableManagerTargetImpl target_impl;
         private:
             Result WaitAnyImpl(WaitableHolderBase **out, bool infinite, TimeSpan timeout, bool reply, Handle reply_target);
             Result WaitAnyHandleImpl(WaitableHolderBase **out, bool infinite, TimeSpan timeout, bool reply, Handle reply_target);
-            s32                BuildHandleArray(Handle out_handles[], WaitableHolderBase *out_objects[], s32 num);
+
+            void AddToArrays(WaitableHolderBase &holder_base);
+            void RemoveFromArrays(WaitableHolderBase &holder_base);
+            void RebuildUserObjectArray();
+
+            bool IsUserObjectArrayValid() const {
+                return this->user_object_count <= static_cast<s32>(MaximumUserObjectCount);
+            }
+
+            template<typename F>
+            void ForEachUserObject(F f) {
+                if (this->IsUserObjectArrayValid()) {
+                    for (s32 i = 0; i < this->user_object_count; i++) {
+                        f(*this->user_objects[i]);
+                    }
+                } else {
+                    /* Kernel objects are no-ops for everything we use this for, so we can just walk the whole list. */
+                    for (WaitableHolderBase &holder_base : this->waitable_list) {
+                        f(holder_base);
+                    }
+                }
+            }
 
             WaitableHolderBase *LinkHoldersToObjectList();
             void                UnlinkHoldersFromObjectList();
@@ -54,6 +85,8 @@ namespace ams::os::impl {
                 return holder;
             }
         public:
+            WaitableManagerImpl() : waitable_list(), signaled_holder(nullptr), current_time(), objects(), user_objects(), wait_count(0), update_count(0), object_handles(), object_count(0), user_object_count(0), cs_wait(), target_impl() { /* ... */ }
+
             /* Wait. */
             WaitableHolderBase *WaitAny() {
                 return this->WaitAnyImpl(true, TimeSpan::FromNanoSeconds(std::numeric_limits<s64>::max()));
@@ -78,10 +111,12 @@ namespace ams::os::impl {
 
             void LinkWaitableHolder(WaitableHolderBase &holder_base) {
                 this->waitable_list.push_back(holder_base);
+                this->AddToArrays(holder_base);
             }
 
             void UnlinkWaitableHolder(WaitableHolderBase &holder_base) {
                 this->waitable_list.erase(this->waitable_list.iterator_to(holder_base));
+                this->RemoveFromArrays(holder_base);
             }
 
             void UnlinkAll() {
@@ -89,14 +124,23 @@ namespace ams::os::impl {
                     this->waitable_list.front().SetManager(nullptr);
                     this->waitable_list.pop_front();
                 }
+
+                this->object_count      = 0;
+                this->user_object_count = 0;
+                this->update_count++;
             }
 
             void MoveAllFrom(WaitableManagerImpl &other) {
-                /* Set manager for all of the other's waitables. */
+                /* Set manager for all of the other's waitables, and append them to our arrays. */
                 for (auto &w : other.waitable_list) {
                     w.SetManager(this);
+                    this->AddToArrays(w);
                 }
                 this->waitable_list.splice(this->waitable_list.end(), other.waitable_list);
+
+                other.object_count      = 0;
+                other.user_object_count = 0;
+                other.update_count++;
             }
 
             /* Other. */
@@ -105,6 +149,15 @@ namespace ams::os::impl {
             }
 
             void SignalAndWakeupThread(WaitableHolderBase *holder_base);
+
+            u64 GetWaitCount() const {
+                return this->wait_count;
+            }
+
+            u64 GetUpdateCount() const {
+                return this->update_count;
+            }
     };
+    static_assert(sizeof(WaitableManagerImpl) == sizeof(os::WaitableManagerType::impl_storage));
 
 }
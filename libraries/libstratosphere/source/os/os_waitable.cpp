@@ -148,4 +148,13 @@ namespace ams::os {
         holder->user_data = 0;
     }
 
+    void GetWaitableManagerStatistics(WaitableManagerStatistics *out, WaitableManagerType *manager) {
+        auto &impl = GetWaitableManagerImpl(manager);
+
+        AMS_ASSERT(manager->state == WaitableManagerType::State_Initialized);
+
+        out->wait_count                = impl.GetWaitCount();
+        out->handle_array_update_count = impl.GetUpdateCount();
+    }
+
 }
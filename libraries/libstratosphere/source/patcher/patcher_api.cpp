@@ -95,6 +95,58 @@ namespace ams::patcher {
             return MatchesModuleId(name, name_len, IpsFileExtensionLength, module_id);
         }
 
+        /* Reads a patch through a read-ahead buffer, so that each record field doesn't need its own file read. */
+        class BufferedPatchReader {
+            NON_COPYABLE(BufferedPatchReader);
+            NON_MOVEABLE(BufferedPatchReader);
+            private:
+                fs::FileHandle file;
+                u8 *buffer;
+                size_t buffer_size;
+                size_t buffered_size;
+                s64 buffer_offset;
+                s64 file_offset;
+            private:
+                bool IsBuffered(s64 offset) const {
+                    return this->buffer_offset <= offset && offset < this->buffer_offset + static_cast<s64>(this->buffered_size);
+                }
+
+                void Fill() {
+                    /* Read as much of the patch as we can from the current offset. */
+                    size_t read_size = 0;
+                    R_ABORT_UNLESS(fs::ReadFile(std::addressof(read_size), this->file, this->file_offset, this->buffer, this->buffer_size));
+
+                    /* Reading past the end of the patch is an error, as it would be for an unbuffered read. */
+                    AMS_ABORT_UNLESS(read_size > 0);
+
+                    this->buffer_offset = this->file_offset;
+                    this->buffered_size = read_size;
+                }
+            public:
+                BufferedPatchReader(fs::FileHandle f, s64 offset, void *buf, size_t buf_size) : file(f), buffer(static_cast<u8 *>(buf)), buffer_size(buf_size), buffered_size(0), buffer_offset(offset), file_offset(offset) { /* ... */ }
+
+                void Read(void *dst, size_t size) {
+                    u8 *cur_dst = static_cast<u8 *>(dst);
+                    while (size > 0) {
+                        if (!this->IsBuffered(this->file_offset)) {
+                            this->Fill();
+                        }
+
+                        const size_t buffer_pos = static_cast<size_t>(this->file_offset - this->buffer_offset);
+                        const size_t cur_size   = std::min(size, this->buffered_size - buffer_pos);
+                        std::memcpy(cur_dst, this->buffer + buffer_pos, cur_size);
+
+                        cur_dst           += cur_size;
+                        size              -= cur_size;
+                        this->file_offset += cur_size;
+                    }
+                }
+
+                void Skip(size_t size) {
+                    this->file_offset += size;
+                }
+        };
+
         inline bool IsIpsTail(bool is_ips32, u8 *buffer) {
             if (is_ips32) {
                 return std::memcmp(buffer, Ips32TailMagic, sizeof(Ips32TailMagic)) == 0;
@@ -119,10 +171,9 @@ namespace ams::patcher {
             /* Validate offset/protected size. */
             AMS_ABORT_UNLESS(offset <= protected_size);
 
-            s64 file_offset = sizeof(IpsHeadMagic);
+            BufferedPatchReader reader(file, sizeof(IpsHeadMagic), g_patch_read_buffer, sizeof(g_patch_read_buffer));
             auto ReadData = [&](void *dst, size_t size) ALWAYS_INLINE_LAMBDA {
-                R_ABORT_UNLESS(fs::ReadFile(file, file_offset, dst, size));
-                file_offset += size;
+                reader.Read(dst, size);
             };
 
             u8 buffer[sizeof(Ips32TailMagic)];
@@ -176,9 +227,9 @@ namespace ams::patcher {
                             const u32 diff = protected_size - patch_offset;
                             patch_offset += diff;
                             patch_size -= diff;
-                            file_offset += diff;
+                            reader.Skip(diff);
                         } else {
-                            file_offset += patch_size;
+                            reader.Skip(patch_size);
                             continue;
                         }
                     }
@@ -191,94 +242,402 @@ namespace ams::patcher {
                     if (patch_offset + read_size > mapped_size) {
                         read_size = mapped_size - patch_offset;
                     }
-                    {
-                        size_t remaining   = read_size;
-                        size_t copy_offset = patch_offset;
-                        while (remaining > 0) {
-                            const size_t cur_read = std::min(remaining, sizeof(g_patch_read_buffer));
-                            ReadData(g_patch_read_buffer, cur_read);
-                            std::memcpy(mapped_module + copy_offset, g_patch_read_buffer, cur_read);
-                            remaining   -= cur_read;
-                            copy_offset += cur_read;
-                        }
-                    }
+                    ReadData(mapped_module + patch_offset, read_size);
                     if (patch_size > read_size) {
-                        file_offset += patch_size - read_size;
+                        reader.Skip(patch_size - read_size);
                     }
                 }
             }
         }
 
-    }
+        void ApplyIpsPatchFile(const char *path, u8 *mapped_module, size_t mapped_size, size_t protected_size, size_t offset) {
+            /* Open the file. */
+            fs::FileHandle file;
+            if (R_FAILED(fs::OpenFile(std::addressof(file), path, fs::OpenMode_Read))) {
+                return;
+            }
+            ON_SCOPE_EXIT { fs::CloseFile(file); };
+
+            /* Read the header. */
+            u8 header[sizeof(IpsHeadMagic)];
+            if (R_SUCCEEDED(fs::ReadFile(file, 0, header, sizeof(header)))) {
+                if (std::memcmp(header, IpsHeadMagic, sizeof(header)) == 0) {
+                    ApplyIpsPatch(mapped_module, mapped_size, protected_size, offset, false, file);
+                } else if (std::memcmp(header, Ips32HeadMagic, sizeof(header)) == 0) {
+                    ApplyIpsPatch(mapped_module, mapped_size, protected_size, offset, true, file);
+                }
+            }
+        }
 
-    void LocateAndApplyIpsPatchesToModule(const char *mount_name, const char *patch_dir_name, size_t protected_size, size_t offset, const ro::ModuleId *module_id, u8 *mapped_module, size_t mapped_size) {
-        /* Ensure only one thread tries to apply patches at a time. */
-        std::scoped_lock lk(apply_patch_lock);
+        /* Remembers which patch files exist under a patch directory, so that loading a module doesn't require walking every patch subdirectory. */
+        /* Before each use, the names of the patch subdirectories are checked against those the index was built from, and it is rebuilt if they've changed. */
+        /* The names of the files within each subdirectory are only checked on the first use after a revalidation is requested. */
+        class PatchIndex {
+            NON_COPYABLE(PatchIndex);
+            NON_MOVEABLE(PatchIndex);
+            public:
+                static constexpr size_t DirectoryCountMax = 0x40;
+                static constexpr size_t FileCountMax      = 0x100;
+                static constexpr size_t NamePoolSize      = 0x2000;
+                static constexpr size_t EntryBufferCount  = 8;
+            private:
+                static constexpr u64 InvalidFingerprint      = 0;
+                static constexpr u64 FingerprintInitialValue = 0xCBF29CE484222325ul;
+                static constexpr u64 FingerprintPrime        = 0x00000100000001B3ul;
+
+                struct DirectoryInfo {
+                    u16 name_offset;
+                    u64 fingerprint;
+                };
+
+                struct FileInfo {
+                    ro::ModuleId module_id;
+                    u16 directory_index;
+                    u16 name_offset;
+                };
+            private:
+                char root_path[fs::EntryNameLengthMax + 1];
+                DirectoryInfo directories[DirectoryCountMax];
+                FileInfo files[FileCountMax];
+                char name_pool[NamePoolSize];
+                fs::DirectoryEntry entry_buffer[EntryBufferCount];
+                u64 root_fingerprint;
+                size_t directory_count;
+                size_t file_count;
+                size_t name_pool_size;
+                bool is_built;
+                bool is_overflowed;
+                bool is_revalidation_requested;
+            private:
+                bool AddName(u16 *out, const char *name) {
+                    const size_t name_size = std::strlen(name) + 1;
+                    if (name_size > NamePoolSize - this->name_pool_size) {
+                        return false;
+                    }
 
-        /* Inspect all patches from /atmosphere/<patch_dir>/<*>/<*>.ips */
-        char path[fs::EntryNameLengthMax + 1];
-        util::SNPrintf(path, sizeof(path), "%s:/atmosphere/%s", mount_name, patch_dir_name);
-        const size_t patches_dir_path_len = std::strlen(path);
+                    std::memcpy(this->name_pool + this->name_pool_size, name, name_size);
+                    *out = static_cast<u16>(this->name_pool_size);
+                    this->name_pool_size += name_size;
+                    return true;
+                }
 
-        /* Open the patch directory. */
-        fs::DirectoryHandle patches_dir;
-        if (R_FAILED(fs::OpenDirectory(std::addressof(patches_dir), path, fs::OpenDirectoryMode_Directory))) {
-            return;
-        }
-        ON_SCOPE_EXIT { fs::CloseDirectory(patches_dir); };
-
-        /* Iterate over the patches directory to find patch subdirectories. */
-        while (true) {
-            /* Read the next entry. */
-            s64 count;
-            fs::DirectoryEntry entry;
-            if (R_FAILED(fs::ReadDirectory(std::addressof(count), std::addressof(entry), patches_dir, 1)) || count == 0) {
-                break;
-            }
+                size_t PrintDirectoryPath(char *dst, size_t dst_size, size_t directory_index) const {
+                    return util::SNPrintf(dst, dst_size, "%s/%s", this->root_path, this->name_pool + this->directories[directory_index].name_offset);
+                }
 
-            /* Print the path for this directory. */
-            util::SNPrintf(path + patches_dir_path_len, sizeof(path) - patches_dir_path_len, "/%s", entry.name);
-            const size_t patch_dir_path_len = patches_dir_path_len + 1 + std::strlen(entry.name);
+                u64 CalculateFingerprint(const char *path, fs::OpenDirectoryMode mode) {
+                    /* Hash the names of the directory's entries, in the order they're read. */
+                    fs::DirectoryHandle dir;
+                    if (R_FAILED(fs::OpenDirectory(std::addressof(dir), path, mode))) {
+                        return InvalidFingerprint;
+                    }
+                    ON_SCOPE_EXIT { fs::CloseDirectory(dir); };
+
+                    u64 fingerprint = FingerprintInitialValue;
+                    while (true) {
+                        s64 count;
+                        if (R_FAILED(fs::ReadDirectory(std::addressof(count), this->entry_buffer, dir, EntryBufferCount))) {
+                            return InvalidFingerprint;
+                        }
+                        if (count == 0) {
+                            break;
+                        }
+
+                        for (s64 i = 0; i < count; i++) {
+                            const char *name = this->entry_buffer[i].name;
+                            do {
+                                fingerprint = (fingerprint ^ static_cast<u8>(*name)) * FingerprintPrime;
+                            } while (*(name++) != '\x00');
+                        }
+                    }
+
+                    return fingerprint;
+                }
+
+                bool BuildImpl(fs::DirectoryHandle patches_dir) {
+                    char path[fs::EntryNameLengthMax + 1];
+
+                    /* Iterate over the patches directory to find patch subdirectories. */
+                    while (true) {
+                        /* Read the next entry. */
+                        s64 count;
+                        fs::DirectoryEntry entry;
+                        if (R_FAILED(fs::ReadDirectory(std::addressof(count), std::addressof(entry), patches_dir, 1)) || count == 0) {
+                            break;
+                        }
+
+                        /* Add the directory to the index. */
+                        if (this->directory_count >= DirectoryCountMax) {
+                            return false;
+                        }
+                        const size_t directory_index = this->directory_count;
+                        DirectoryInfo *directory = std::addressof(this->directories[directory_index]);
+                        if (!this->AddName(std::addressof(directory->name_offset), entry.name)) {
+                            return false;
+                        }
+                        this->directory_count++;
+
+                        /* Fingerprint the patch directory before reading it, so that anything changed while we read it makes the index stale. */
+                        this->PrintDirectoryPath(path, sizeof(path), directory_index);
+                        directory->fingerprint = this->CalculateFingerprint(path, fs::OpenDirectoryMode_File);
+
+                        /* Open the patch directory. */
+                        fs::DirectoryHandle patch_dir;
+                        if (R_FAILED(fs::OpenDirectory(std::addressof(patch_dir), path, fs::OpenDirectoryMode_File))) {
+                            continue;
+                        }
+                        ON_SCOPE_EXIT { fs::CloseDirectory(patch_dir); };
+
+                        /* Iterate over files in the patch directory. */
+                        while (true) {
+                            if (R_FAILED(fs::ReadDirectory(std::addressof(count), std::addressof(entry), patch_dir, 1)) || count == 0) {
+                                break;
+                            }
+
+                            /* Check if this file is an ips for any module. */
+                            const size_t name_len = std::strlen(entry.name);
+                            if (!(IpsFileExtensionLength < name_len && name_len <= ModuleIpsPatchLength) || !util::IsAligned(name_len, 2)) {
+                                continue;
+                            }
+                            if (std::strcmp(entry.name + name_len - IpsFileExtensionLength, IpsFileExtension) != 0) {
+                                continue;
+                            }
+
+                            ro::ModuleId module_id;
+                            if (!ParseModuleIdFromPath(std::addressof(module_id), entry.name, name_len, IpsFileExtensionLength)) {
+                                continue;
+                            }
+
+                            /* Add the file to the index. */
+                            if (this->file_count >= FileCountMax) {
+                                return false;
+                            }
+                            FileInfo *file = std::addressof(this->files[this->file_count]);
+                            if (!this->AddName(std::addressof(file->name_offset), entry.name)) {
+                                return false;
+                            }
+                            file->module_id       = module_id;
+                            file->directory_index = static_cast<u16>(directory_index);
+                            this->file_count++;
+                        }
+                    }
+
+                    return true;
+                }
+            public:
+                constexpr PatchIndex() : root_path(), directories(), files(), name_pool(), entry_buffer(), root_fingerprint(InvalidFingerprint), directory_count(0), file_count(0), name_pool_size(0), is_built(false), is_overflowed(false), is_revalidation_requested(false) { /* ... */ }
+
+                bool IsOverflowed() const {
+                    return this->is_overflowed;
+                }
+
+                void RequestRevalidation() {
+                    this->is_revalidation_requested = true;
+                }
+
+                bool IsUpToDate(const char *path) {
+                    /* The index must have been built for this path. */
+                    if (!this->is_built || std::strcmp(this->root_path, path) != 0) {
+                        return false;
+                    }
+
+                    /* The set of patch subdirectories must not have changed. */
+                    const u64 root_fingerprint = this->CalculateFingerprint(this->root_path, fs::OpenDirectoryMode_Directory);
+                    if (root_fingerprint == InvalidFingerprint || root_fingerprint != this->root_fingerprint) {
+                        return false;
+                    }
+
+                    /* Unless we've been asked to revalidate, or the index couldn't hold every patch, there's nothing more to check. */
+                    if (!this->is_revalidation_requested || this->is_overflowed) {
+                        return true;
+                    }
+
+                    /* The set of files in each subdirectory must not have changed. */
+                    char dir_path[fs::EntryNameLengthMax + 1];
+                    for (size_t i = 0; i < this->directory_count; i++) {
+                        this->PrintDirectoryPath(dir_path, sizeof(dir_path), i);
+                        if (this->CalculateFingerprint(dir_path, fs::OpenDirectoryMode_File) != this->directories[i].fingerprint) {
+                            return false;
+                        }
+                    }
+
+                    this->is_revalidation_requested = false;
+                    return true;
+                }
+
+                bool Build(const char *path) {
+                    /* Reset the index. */
+                    this->is_built                  = false;
+                    this->is_overflowed             = false;
+                    this->is_revalidation_requested = false;
+                    this->directory_count           = 0;
+                    this->file_count                = 0;
+                    this->name_pool_size            = 0;
+                    util::Strlcpy(this->root_path, path, sizeof(this->root_path));
+
+                    /* Fingerprint the patch directory before reading it, so that anything changed while we read it makes the index stale. */
+                    this->root_fingerprint = this->CalculateFingerprint(this->root_path, fs::OpenDirectoryMode_Directory);
+                    if (this->root_fingerprint == InvalidFingerprint) {
+                        return false;
+                    }
+
+                    /* Open the patch directory. */
+                    fs::DirectoryHandle patches_dir;
+                    if (R_FAILED(fs::OpenDirectory(std::addressof(patches_dir), this->root_path, fs::OpenDirectoryMode_Directory))) {
+                        return false;
+                    }
+                    ON_SCOPE_EXIT { fs::CloseDirectory(patches_dir); };
+
+                    /* Index the patches, noting whether they all fit. */
+                    this->is_overflowed = !this->BuildImpl(patches_dir);
+                    this->is_built      = true;
+                    return true;
+                }
+
+                size_t Find(u16 *out_indices, size_t max_indices, const ro::ModuleId *module_id) const {
+                    AMS_ABORT_UNLESS(!this->is_overflowed);
+
+                    /* Find the patches for the module, in the order a directory walk would encounter them. */
+                    size_t count = 0;
+                    for (size_t i = 0; i < this->file_count && count < max_indices; i++) {
+                        if (std::memcmp(std::addressof(this->files[i].module_id), module_id, sizeof(*module_id)) == 0) {
+                            out_indices[count++] = static_cast<u16>(i);
+                        }
+                    }
+                    return count;
+                }
+
+                void PrintFilePath(char *dst, size_t dst_size, u16 file_index) const {
+                    const FileInfo &file = this->files[file_index];
+                    const size_t dir_path_len = this->PrintDirectoryPath(dst, dst_size, file.directory_index);
+                    if (dir_path_len < dst_size) {
+                        util::SNPrintf(dst + dir_path_len, dst_size - dir_path_len, "/%s", this->name_pool + file.name_offset);
+                    }
+                }
+        };
+
+        PatchIndex g_patch_index;
+
+        os::Tick g_patch_index_build_tick;
+        os::Tick g_patch_index_lookup_tick;
+        u64 g_patch_index_build_count;
+        u64 g_patch_index_lookup_count;
+
+        void LocateAndApplyIpsPatchesToModuleByDirectoryWalk(const char *patches_dir_path, size_t protected_size, size_t offset, const ro::ModuleId *module_id, u8 *mapped_module, size_t mapped_size) {
+            char path[fs::EntryNameLengthMax + 1];
+            util::Strlcpy(path, patches_dir_path, sizeof(path));
+            const size_t patches_dir_path_len = std::strlen(path);
 
             /* Open the patch directory. */
-            fs::DirectoryHandle patch_dir;
-            if (R_FAILED(fs::OpenDirectory(std::addressof(patch_dir), path, fs::OpenDirectoryMode_File))) {
-                continue;
+            fs::DirectoryHandle patches_dir;
+            if (R_FAILED(fs::OpenDirectory(std::addressof(patches_dir), path, fs::OpenDirectoryMode_Directory))) {
+                return;
             }
-            ON_SCOPE_EXIT { fs::CloseDirectory(patch_dir); };
+            ON_SCOPE_EXIT { fs::CloseDirectory(patches_dir); };
 
-            /* Iterate over files in the patch directory. */
+            /* Iterate over the patches directory to find patch subdirectories. */
             while (true) {
-                if (R_FAILED(fs::ReadDirectory(std::addressof(count), std::addressof(entry), patch_dir, 1)) || count == 0) {
+                /* Read the next entry. */
+                s64 count;
+                fs::DirectoryEntry entry;
+                if (R_FAILED(fs::ReadDirectory(std::addressof(count), std::addressof(entry), patches_dir, 1)) || count == 0) {
                     break;
                 }
 
-                /* Check if this file is an ips. */
-                if (!IsIpsFileForModule(entry.name, module_id)) {
+                /* Print the path for this directory. */
+                util::SNPrintf(path + patches_dir_path_len, sizeof(path) - patches_dir_path_len, "/%s", entry.name);
+                const size_t patch_dir_path_len = patches_dir_path_len + 1 + std::strlen(entry.name);
+
+                /* Open the patch directory. */
+                fs::DirectoryHandle patch_dir;
+                if (R_FAILED(fs::OpenDirectory(std::addressof(patch_dir), path, fs::OpenDirectoryMode_File))) {
                     continue;
                 }
+                ON_SCOPE_EXIT { fs::CloseDirectory(patch_dir); };
 
-                /* Print the path for this file. */
-                util::SNPrintf(path + patch_dir_path_len, sizeof(path) - patch_dir_path_len, "/%s", entry.name);
+                /* Iterate over files in the patch directory. */
+                while (true) {
+                    if (R_FAILED(fs::ReadDirectory(std::addressof(count), std::addressof(entry), patch_dir, 1)) || count == 0) {
+                        break;
+                    }
 
-                /* Open the file. */
-                fs::FileHandle file;
-                if (R_FAILED(fs::OpenFile(std::addressof(file), path, fs::OpenMode_Read))) {
-                    continue;
-                }
-                ON_SCOPE_EXIT { fs::CloseFile(file); };
-
-                /* Read the header. */
-                u8 header[sizeof(IpsHeadMagic)];
-                if (R_SUCCEEDED(fs::ReadFile(file, 0, header, sizeof(header)))) {
-                    if (std::memcmp(header, IpsHeadMagic, sizeof(header)) == 0) {
-                        ApplyIpsPatch(mapped_module, mapped_size, protected_size, offset, false, file);
-                    } else if (std::memcmp(header, Ips32HeadMagic, sizeof(header)) == 0) {
-                        ApplyIpsPatch(mapped_module, mapped_size, protected_size, offset, true, file);
+                    /* Check if this file is an ips. */
+                    if (!IsIpsFileForModule(entry.name, module_id)) {
+                        continue;
                     }
+
+                    /* Print the path for this file. */
+                    util::SNPrintf(path + patch_dir_path_len, sizeof(path) - patch_dir_path_len, "/%s", entry.name);
+
+                    /* Apply the patch. */
+                    ApplyIpsPatchFile(path, mapped_module, mapped_size, protected_size, offset);
                 }
             }
         }
+
+    }
+
+    void LocateAndApplyIpsPatchesToModule(const char *mount_name, const char *patch_dir_name, size_t protected_size, size_t offset, const ro::ModuleId *module_id, u8 *mapped_module, size_t mapped_size) {
+        /* Ensure only one thread tries to apply patches at a time. */
+        std::scoped_lock lk(apply_patch_lock);
+
+        /* Inspect all patches from /atmosphere/<patch_dir>/<*>/<*>.ips */
+        char path[fs::EntryNameLengthMax + 1];
+        util::SNPrintf(path, sizeof(path), "%s:/atmosphere/%s", mount_name, patch_dir_name);
+
+        /* Find the patches for the module, (re)building our index if it's stale. */
+        u16 patch_indices[PatchIndex::FileCountMax];
+        size_t num_patches = 0;
+        {
+            const auto start_tick = os::GetSystemTick();
+            const bool is_up_to_date = g_patch_index.IsUpToDate(path);
+            const auto checked_tick = os::GetSystemTick();
+
+            if (!is_up_to_date) {
+                const bool built = g_patch_index.Build(path);
+
+                g_patch_index_build_tick += os::GetSystemTick() - checked_tick;
+                g_patch_index_build_count++;
+
+                /* If there's no patch directory, there's nothing to apply. */
+                if (!built) {
+                    return;
+                }
+            }
+
+            /* If we couldn't index every patch, fall back to walking the patch directory. */
+            if (g_patch_index.IsOverflowed()) {
+                LocateAndApplyIpsPatchesToModuleByDirectoryWalk(path, protected_size, offset, module_id, mapped_module, mapped_size);
+                return;
+            }
+
+            const auto find_tick = os::GetSystemTick();
+            num_patches = g_patch_index.Find(patch_indices, util::size(patch_indices), module_id);
+
+            g_patch_index_lookup_tick += (checked_tick - start_tick) + (os::GetSystemTick() - find_tick);
+            g_patch_index_lookup_count++;
+        }
+
+        /* Apply each patch. */
+        for (size_t i = 0; i < num_patches; i++) {
+            g_patch_index.PrintFilePath(path, sizeof(path), patch_indices[i]);
+            ApplyIpsPatchFile(path, mapped_module, mapped_size, protected_size, offset);
+        }
+    }
+
+    void RequestPatchIndexRevalidation() {
+        std::scoped_lock lk(apply_patch_lock);
+
+        g_patch_index.RequestRevalidation();
+    }
+
+    void GetPatchIndexStatistics(PatchIndexStatistics *out) {
+        std::scoped_lock lk(apply_patch_lock);
+
+        out->build_count  = g_patch_index_build_count;
+        out->build_time   = g_patch_index_build_tick.ToTimeSpan();
+        out->lookup_count = g_patch_index_lookup_count;
+        out->lookup_time  = g_patch_index_lookup_tick.ToTimeSpan();
     }
 
 }
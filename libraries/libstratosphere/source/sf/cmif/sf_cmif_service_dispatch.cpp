@@ -17,6 +17,25 @@
 
 namespace ams::sf::cmif {
 
+    namespace {
+
+        decltype(ServiceCommandMeta::handler) FindCommandHandler(const ServiceCommandMeta *entries, const size_t entry_count, u32 cmd_id, hos::Version hos_version) {
+            /* Entries are sorted by command id, so find the first entry for our command. */
+            const ServiceCommandMeta *entries_end = entries + entry_count;
+            const ServiceCommandMeta *it = std::lower_bound(entries, entries_end, cmd_id, [](const ServiceCommandMeta &meta, u32 id) { return meta.cmd_id < id; });
+
+            /* Find the entry valid for our version. */
+            for (/* ... */; it != entries_end && it->cmd_id == cmd_id; ++it) {
+                if (it->Matches(cmd_id, hos_version)) {
+                    return it->GetHandler();
+                }
+            }
+
+            return nullptr;
+        }
+
+    }
+
     Result impl::ServiceDispatchTableBase::ProcessMessageImpl(ServiceDispatchContext &ctx, const cmif::PointerAndSize &in_raw_data, const ServiceCommandMeta *entries, const size_t entry_count) const {
         /* Get versioning info. */
         const auto hos_version      = hos::GetVersion();
@@ -30,13 +49,7 @@ namespace ams::sf::cmif {
         const u32 cmd_id = in_header->command_id;
 
         /* Find a handler. */
-        decltype(ServiceCommandMeta::handler) cmd_handler = nullptr;
-        for (size_t i = 0; i < entry_count; i++) {
-            if (entries[i].Matches(cmd_id, hos_version)) {
-                cmd_handler = entries[i].GetHandler();
-                break;
-            }
-        }
+        const auto cmd_handler = FindCommandHandler(entries, entry_count, cmd_id, hos_version);
         R_UNLESS(cmd_handler != nullptr, sf::cmif::ResultUnknownCommandId());
 
         /* Invoke handler. */
@@ -73,13 +86,7 @@ namespace ams::sf::cmif {
         const u32 cmd_id = in_header->command_id;
 
         /* Find a handler. */
-        decltype(ServiceCommandMeta::handler) cmd_handler = nullptr;
-        for (size_t i = 0; i < entry_count; i++) {
-            if (entries[i].Matches(cmd_id, hos_version)) {
-                cmd_handler = entries[i].GetHandler();
-                break;
-            }
-        }
+        const auto cmd_handler = FindCommandHandler(entries, entry_count, cmd_id, hos_version);
 
         /* If we didn't find a handler, forward the request. */
         if (cmd_handler == nullptr) {
@@ -18,6 +18,14 @@
 
 namespace ams::sf::hipc {
 
+    namespace {
+
+        void LoopProcessThreadFunction(void *arg) {
+            static_cast<ServerManagerBase *>(arg)->LoopProcess();
+        }
+
+    }
+
     Result ServerManagerBase::InstallMitmServerImpl(Handle *out_port_handle, sm::ServiceName service_name, ServerManagerBase::MitmQueryFunction query_func) {
         /* Install the Mitm. */
         Handle query_handle;
@@ -43,8 +51,35 @@ namespace ams::sf::hipc {
 
     void ServerManagerBase::RegisterToWaitList(os::WaitableHolderType *holder) {
         std::scoped_lock lk(this->waitlist_mutex);
-        os::LinkWaitableHolder(std::addressof(this->waitlist), holder);
-        this->notify_event.Signal();
+
+        /* User waitables always go to the main tier, servers and sessions only do while it has room. */
+        if (this->num_wait_shards == 0 || !IsServerOrSession(holder) || this->main_tier_count < this->main_tier_capacity) {
+            if (this->num_wait_shards > 0 && IsServerOrSession(holder)) {
+                this->main_tier_count++;
+            }
+
+            os::LinkWaitableHolder(std::addressof(this->waitlist), holder);
+            this->notify_event.Signal();
+            return;
+        }
+
+        /* Otherwise, hand the holder to the first wait shard with room, so that as few helper threads run as possible. */
+        WaitShard *shard = nullptr;
+        for (size_t i = 0; i < this->num_wait_shards; i++) {
+            if (this->wait_shards[i].count < ServerSessionCountMax) {
+                shard = std::addressof(this->wait_shards[i]);
+                break;
+            }
+        }
+        AMS_ABORT_UNLESS(shard != nullptr);
+
+        if (!shard->is_started) {
+            this->StartWaitShard(shard);
+        }
+
+        shard->count++;
+        os::LinkWaitableHolder(std::addressof(shard->waitlist), holder);
+        shard->notify_event.Signal();
     }
 
     void ServerManagerBase::ProcessWaitList() {
@@ -52,10 +87,95 @@ namespace ams::sf::hipc {
         os::MoveAllWaitableHolder(std::addressof(this->waitable_manager), std::addressof(this->waitlist));
     }
 
+    void ServerManagerBase::StartWaitShard(WaitShard *shard) {
+        R_ABORT_UNLESS(os::CreateThread(std::addressof(shard->thread), WaitShardThreadFunction, shard, shard->thread_stack, WaitShardThreadStackSize, os::GetThreadCurrentPriority(os::GetCurrentThread())));
+        os::StartThread(std::addressof(shard->thread));
+        shard->is_started = true;
+    }
+
+    void ServerManagerBase::WaitShardThreadFunction(void *arg) {
+        WaitShard *shard = static_cast<WaitShard *>(arg);
+        shard->manager->LoopProcessWaitShard(shard);
+    }
+
+    void ServerManagerBase::LoopProcessWaitShard(WaitShard *shard) {
+        while (true) {
+            /* Link anything newly assigned to us, unless we've been told to stop. */
+            {
+                std::scoped_lock lk(this->waitlist_mutex);
+                if (shard->is_stop_requested) {
+                    break;
+                }
+                os::MoveAllWaitableHolder(std::addressof(shard->waitable_manager), std::addressof(shard->waitlist));
+            }
+
+            auto selected = os::WaitAny(std::addressof(shard->waitable_manager));
+            if (selected == std::addressof(shard->notify_event_holder)) {
+                shard->notify_event.Clear();
+            } else {
+                /* Forward the signaled holder to the processing threads. */
+                os::UnlinkWaitableHolder(selected);
+
+                std::scoped_lock lk(this->waitlist_mutex);
+                AMS_ABORT_UNLESS(this->ready_holders_count < this->ready_holders_capacity);
+
+                this->ready_holders[(this->ready_holders_head + this->ready_holders_count) % this->ready_holders_capacity] = selected;
+                this->ready_holders_count++;
+                shard->count--;
+
+                this->notify_event.Signal();
+            }
+        }
+    }
+
+    void ServerManagerBase::FinalizeWaitShards() {
+        for (size_t i = 0; i < this->num_wait_shards; i++) {
+            WaitShard *shard = std::addressof(this->wait_shards[i]);
+            if (!shard->is_started) {
+                continue;
+            }
+
+            {
+                std::scoped_lock lk(this->waitlist_mutex);
+                shard->is_stop_requested = true;
+                shard->notify_event.Signal();
+            }
+
+            os::WaitThread(std::addressof(shard->thread));
+            os::DestroyThread(std::addressof(shard->thread));
+            shard->is_started = false;
+        }
+    }
+
+    os::WaitableHolderType *ServerManagerBase::TakeReadyHolder() {
+        /* Don't hand out work once we've been asked to stop. */
+        if (this->request_stop_event.TryWait()) {
+            return nullptr;
+        }
+
+        std::scoped_lock lk(this->waitlist_mutex);
+        if (this->ready_holders_count == 0) {
+            return nullptr;
+        }
+
+        auto *holder = this->ready_holders[this->ready_holders_head];
+        this->ready_holders_head = (this->ready_holders_head + 1) % this->ready_holders_capacity;
+        this->ready_holders_count--;
+        return holder;
+    }
+
     os::WaitableHolderType *ServerManagerBase::WaitSignaled() {
         std::scoped_lock lk(this->waitable_selection_mutex);
         while (true) {
             this->ProcessWaitList();
+
+            /* Take anything our wait shards have forwarded to us. */
+            if (this->num_wait_shards > 0) {
+                if (auto ready = this->TakeReadyHolder(); ready != nullptr) {
+                    return ready;
+                }
+            }
+
             auto selected = os::WaitAny(std::addressof(this->waitable_manager));
             if (selected == &this->request_stop_event_holder) {
                 return nullptr;
@@ -63,6 +183,12 @@ namespace ams::sf::hipc {
                 this->notify_event.Clear();
             } else {
                 os::UnlinkWaitableHolder(selected);
+
+                if (this->num_wait_shards > 0 && IsServerOrSession(selected)) {
+                    std::scoped_lock wlk(this->waitlist_mutex);
+                    this->main_tier_count--;
+                }
+
                 return selected;
             }
         }
@@ -164,4 +290,27 @@ namespace ams::sf::hipc {
         }
     }
 
+    void ServerManagerBase::LoopProcessMultiThreaded(os::ThreadType *extra_threads, void *extra_thread_stacks, size_t extra_thread_stack_size, size_t num_extra_threads, s32 priority) {
+        AMS_ABORT_UNLESS(util::IsAligned(reinterpret_cast<uintptr_t>(extra_thread_stacks), os::ThreadStackAlignment));
+        AMS_ABORT_UNLESS(util::IsAligned(extra_thread_stack_size, os::ThreadStackAlignment));
+
+        /* Create and start the extra threads. */
+        u8 *stacks = static_cast<u8 *>(extra_thread_stacks);
+        for (size_t i = 0; i < num_extra_threads; i++) {
+            R_ABORT_UNLESS(os::CreateThread(extra_threads + i, LoopProcessThreadFunction, this, stacks + i * extra_thread_stack_size, extra_thread_stack_size, priority));
+        }
+        for (size_t i = 0; i < num_extra_threads; i++) {
+            os::StartThread(extra_threads + i);
+        }
+
+        /* Loop this thread. */
+        this->LoopProcess();
+
+        /* Stopping is signaled by a manual-clear event, so every thread will see it; wait for the extra threads to finish. */
+        for (size_t i = 0; i < num_extra_threads; i++) {
+            os::WaitThread(extra_threads + i);
+            os::DestroyThread(extra_threads + i);
+        }
+    }
+
 }
@@ -410,4 +410,12 @@ namespace ams::mitm::fs {
         return ResultSuccess();
     }
 
+    void FsMitmService::AtmosphereGetLooseSdFileCacheStatistics(sf::Out<LooseSdFileCacheStatistics> out) {
+        GetLooseSdFileCacheStatistics(out.GetPointer());
+    }
+
+    void FsMitmService::AtmosphereGetLastRomfsBuildStatistics(sf::Out<romfs::BuildStatistics> out) {
+        romfs::GetLastBuildStatistics(out.GetPointer());
+    }
+
 }
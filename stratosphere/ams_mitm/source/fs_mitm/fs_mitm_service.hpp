@@ -16,6 +16,8 @@
 #pragma once
 #include <stratosphere.hpp>
 #include <stratosphere/fssrv/fssrv_interface_adapters.hpp>
+#include "fsmitm_loose_sd_file_cache.hpp"
+#include "fsmitm_romfs.hpp"
 
 #define AMS_FS_MITM_INTERFACE_INFO(C, H)                                                                                                                                                                                                                                               \
     AMS_SF_METHOD_INFO(C, H,   7, Result, OpenFileSystemWithPatch,         (sf::Out<sf::SharedPointer<ams::fssrv::sf::IFileSystem>> out, ncm::ProgramId program_id, u32 _filesystem_type),                              (out, program_id, _filesystem_type),       hos::Version_2_0_0) \
@@ -24,7 +26,9 @@
     AMS_SF_METHOD_INFO(C, H,  51, Result, OpenSaveDataFileSystem,          (sf::Out<sf::SharedPointer<ams::fssrv::sf::IFileSystem>> out, u8 space_id, const ams::fs::SaveDataAttribute &attribute),                     (out, space_id, attribute))                                    \
     AMS_SF_METHOD_INFO(C, H,  12, Result, OpenBisStorage,                  (sf::Out<sf::SharedPointer<ams::fssrv::sf::IStorage>> out, u32 bis_partition_id),                                                            (out, bis_partition_id))                                       \
     AMS_SF_METHOD_INFO(C, H, 200, Result, OpenDataStorageByCurrentProcess, (sf::Out<sf::SharedPointer<ams::fssrv::sf::IStorage>> out),                                                                                  (out))                                                         \
-    AMS_SF_METHOD_INFO(C, H, 202, Result, OpenDataStorageByDataId,         (sf::Out<sf::SharedPointer<ams::fssrv::sf::IStorage>> out, ncm::DataId data_id, u8 storage_id),                                              (out, data_id, storage_id))
+    AMS_SF_METHOD_INFO(C, H, 202, Result, OpenDataStorageByDataId,         (sf::Out<sf::SharedPointer<ams::fssrv::sf::IStorage>> out, ncm::DataId data_id, u8 storage_id),                                              (out, data_id, storage_id))                                    \
+    AMS_SF_METHOD_INFO(C, H, 65000, void, AtmosphereGetLooseSdFileCacheStatistics, (sf::Out<ams::mitm::fs::LooseSdFileCacheStatistics> out),                                                                   (out))                                    \
+    AMS_SF_METHOD_INFO(C, H, 65001, void, AtmosphereGetLastRomfsBuildStatistics,   (sf::Out<ams::mitm::fs::romfs::BuildStatistics> out),                                                                       (out))
 
 AMS_SF_DEFINE_MITM_INTERFACE(ams::mitm::fs, IFsMitmInterface, AMS_FS_MITM_INTERFACE_INFO)
 
@@ -80,6 +84,10 @@ namespace ams::mitm::fs {
             Result OpenBisStorage(sf::Out<sf::SharedPointer<ams::fssrv::sf::IStorage>> out, u32 bis_partition_id);
             Result OpenDataStorageByCurrentProcess(sf::Out<sf::SharedPointer<ams::fssrv::sf::IStorage>> out);
             Result OpenDataStorageByDataId(sf::Out<sf::SharedPointer<ams::fssrv::sf::IStorage>> out, ncm::DataId data_id, u8 storage_id);
+
+            /* Atmosphere commands. */
+            void AtmosphereGetLooseSdFileCacheStatistics(sf::Out<LooseSdFileCacheStatistics> out);
+            void AtmosphereGetLastRomfsBuildStatistics(sf::Out<romfs::BuildStatistics> out);
     };
     static_assert(IsIFsMitmInterface<FsMitmService>);
 
@@ -17,6 +17,7 @@
 #include "../amsmitm_initialization.hpp"
 #include "../amsmitm_fs_utils.hpp"
 #include "fsmitm_layered_romfs_storage.hpp"
+#include "fsmitm_romfs_cache.hpp"
 
 namespace ams::mitm::fs {
 
@@ -42,6 +43,20 @@ namespace ams::mitm::fs {
         os::ThreadType g_romfs_initializer_thread;
         alignas(os::ThreadStackAlignment) u8 g_romfs_initializer_thread_stack[RomfsInitializerThreadStackSize];
 
+        constexpr u32 DefaultLooseSdFileCacheCapacity = 8;
+        constexpr u32 MaxLooseSdFileCacheCapacity     = 32;
+
+        size_t GetLooseSdFileCacheCapacity() {
+            static const u32 s_capacity = [] {
+                u32 capacity = DefaultLooseSdFileCacheCapacity;
+                settings::fwdbg::GetSettingsItemValue(&capacity, sizeof(capacity), "atmosphere", "fsmitm_romfs_file_cache_count");
+
+                /* Every layered romfs keeps this many files open, so don't let a large value exhaust our file handles. */
+                return std::min(capacity, MaxLooseSdFileCacheCapacity);
+            }();
+            return s_capacity;
+        }
+
         void RequestInitializeStorage(uintptr_t storage_uptr) {
             std::scoped_lock lk(g_mq_lock);
 
@@ -58,11 +73,21 @@ namespace ams::mitm::fs {
             AMS_ABORT_UNLESS(ack == storage_uptr);
         }
 
+        ALWAYS_INLINE s64 GetPhysicalOffset(const romfs::SourceInfo &source) {
+            switch (source.source_type) {
+                case romfs::DataSourceType::Storage:
+                    return source.storage_source_info.offset;
+                case romfs::DataSourceType::File:
+                    return source.file_source_info.offset;
+                AMS_UNREACHABLE_DEFAULT_CASE();
+            }
+        }
+
     }
 
     using namespace ams::fs;
 
-    LayeredRomfsStorage::LayeredRomfsStorage(std::unique_ptr<IStorage> s_r, std::unique_ptr<IStorage> f_r, ncm::ProgramId pr_id) : storage_romfs(std::move(s_r)), file_romfs(std::move(f_r)), initialize_event(os::EventClearMode_ManualClear), program_id(std::move(pr_id)), is_initialized(false), started_initialize(false) {
+    LayeredRomfsStorage::LayeredRomfsStorage(std::unique_ptr<IStorage> s_r, std::unique_ptr<IStorage> f_r, ncm::ProgramId pr_id) : storage_romfs(std::move(s_r)), file_romfs(std::move(f_r)), initialize_event(os::EventClearMode_ManualClear), program_id(std::move(pr_id)), loose_file_cache(this->program_id, GetLooseSdFileCacheCapacity()), is_initialized(false), started_initialize(false) {
         /* ... */
     }
 
@@ -79,25 +104,54 @@ namespace ams::mitm::fs {
     }
 
     void LayeredRomfsStorage::InitializeImpl() {
-        /* Build new virtual romfs. */
-        romfs::Builder builder(this->program_id);
+        const bool use_sd = mitm::IsInitialized();
 
-        if (mitm::IsInitialized()) {
-            builder.AddSdFiles();
-        }
-        if (this->file_romfs) {
-            builder.AddStorageFiles(this->file_romfs.get(), romfs::DataSourceType::File);
-        }
-        if (this->storage_romfs) {
-            builder.AddStorageFiles(this->storage_romfs.get(), romfs::DataSourceType::Storage);
+        /* Try to reuse the virtual romfs built on a previous launch, if its sources haven't changed. */
+        romfs::CacheFingerprint fingerprint;
+        if (use_sd) {
+            romfs::CalculateCacheFingerprint(&fingerprint, this->program_id, use_sd, this->file_romfs.get(), this->storage_romfs.get());
         }
 
-        builder.Build(&this->source_infos);
+        if (!use_sd || !romfs::LoadSourceInfosFromCache(&this->source_infos, this->program_id, fingerprint)) {
+            /* Build new virtual romfs. */
+            romfs::Builder builder(this->program_id);
+
+            if (use_sd) {
+                builder.AddSdFiles();
+            }
+            if (this->file_romfs) {
+                builder.AddStorageFiles(this->file_romfs.get(), romfs::DataSourceType::File);
+            }
+            if (this->storage_romfs) {
+                builder.AddStorageFiles(this->storage_romfs.get(), romfs::DataSourceType::Storage);
+            }
+
+            builder.Build(&this->source_infos);
+
+            /* Save the result, so that the next launch can skip building. */
+            if (use_sd) {
+                romfs::SaveSourceInfosToCache(this->source_infos, this->program_id, fingerprint);
+            }
+        }
 
         this->is_initialized = true;
         this->initialize_event.Signal();
     }
 
+    LayeredRomfsStorage::SourceInfoIterator LayeredRomfsStorage::FindLastCoalescableSource(SourceInfoIterator it, s64 end_offset) const {
+        /* Sources can be read together when they use the same backing storage at the same virtual-to-physical delta. */
+        const auto source_type = it->source_type;
+        const s64 delta = GetPhysicalOffset(*it) - it->virtual_offset;
+
+        for (auto next = it + 1; next != this->source_infos.end() && next->virtual_offset < end_offset; it = next++) {
+            if (next->source_type != source_type || GetPhysicalOffset(*next) - next->virtual_offset != delta) {
+                break;
+            }
+        }
+
+        return it;
+    }
+
     Result LayeredRomfsStorage::Read(s64 offset, void *buffer, size_t size) {
         /* Check if we can succeed immediately. */
         R_UNLESS(size >= 0, fs::ResultInvalidSize());
@@ -117,7 +171,7 @@ namespace ams::mitm::fs {
         }
 
         /* Find first source info via binary search. */
-        auto it = std::lower_bound(this->source_infos.begin(), this->source_infos.end(), offset);
+        SourceInfoIterator it = std::lower_bound(this->source_infos.cbegin(), this->source_infos.cend(), offset);
         u8 *cur_dst = static_cast<u8 *>(buffer);
 
         /* Our operator < compares against start of info instead of end, so we need to subtract one from lower bound. */
@@ -130,25 +184,35 @@ namespace ams::mitm::fs {
 
             if (offset < cur_source.virtual_offset + cur_source.size) {
                 const s64 offset_within_source = offset - cur_source.virtual_offset;
-                const size_t cur_read_size = std::min(size - read_so_far, size_t(cur_source.size - offset_within_source));
+                size_t cur_read_size = std::min(size - read_so_far, size_t(cur_source.size - offset_within_source));
                 switch (cur_source.source_type) {
                     case romfs::DataSourceType::Storage:
-                        R_ABORT_UNLESS(this->storage_romfs->Read(cur_source.storage_source_info.offset + offset_within_source, cur_dst, cur_read_size));
-                        break;
                     case romfs::DataSourceType::File:
-                        R_ABORT_UNLESS(this->file_romfs->Read(cur_source.file_source_info.offset + offset_within_source, cur_dst, cur_read_size));
-                        break;
-                    case romfs::DataSourceType::LooseSdFile:
                         {
-                            FsFile file;
-                            R_ABORT_UNLESS(mitm::fs::OpenAtmosphereSdRomfsFile(&file, this->program_id, cur_source.loose_source_info.path, OpenMode_Read));
-                            ON_SCOPE_EXIT { fsFileClose(&file); };
-
-                            u64 out_read = 0;
-                            R_ABORT_UNLESS(fsFileRead(&file, offset_within_source, cur_dst, cur_read_size, FsReadOption_None, &out_read));
-                            AMS_ABORT_UNLESS(out_read == cur_read_size);
+                            /* Coalesce any following sources which map to the same backing range into a single read. */
+                            const auto last = this->FindLastCoalescableSource(it, offset + static_cast<s64>(size - read_so_far));
+                            const s64 read_end = std::min(last->virtual_offset + last->size, offset + static_cast<s64>(size - read_so_far));
+                            cur_read_size = static_cast<size_t>(read_end - offset);
+
+                            IStorage *backing_storage = cur_source.source_type == romfs::DataSourceType::Storage ? this->storage_romfs.get() : this->file_romfs.get();
+                            R_ABORT_UNLESS(backing_storage->Read(GetPhysicalOffset(cur_source) + offset_within_source, cur_dst, cur_read_size));
+
+                            /* The backing storage may have anything between sources, so fill padding in place. */
+                            for (auto prev = it; prev != last; ++prev) {
+                                const auto next = prev + 1;
+                                const s64 padding_start = prev->virtual_offset + prev->size;
+                                const s64 padding_end   = std::min(next->virtual_offset, read_end);
+                                if (padding_start < padding_end) {
+                                    std::memset(cur_dst + (padding_start - offset), 0, padding_end - padding_start);
+                                }
+                            }
+
+                            it = last;
                         }
                         break;
+                    case romfs::DataSourceType::LooseSdFile:
+                        R_ABORT_UNLESS(this->loose_file_cache.Read(static_cast<u32>(it - this->source_infos.cbegin()), cur_source.loose_source_info.path, offset_within_source, cur_dst, cur_read_size));
+                        break;
                     case romfs::DataSourceType::Memory:
                         std::memcpy(cur_dst, cur_source.memory_source_info.data + offset_within_source, cur_read_size);
                         break;
@@ -167,7 +231,7 @@ namespace ams::mitm::fs {
             } else {
                 /* Explicitly handle padding. */
                 const auto &next_source = *(++it);
-                const size_t padding_size = size_t(next_source.virtual_offset - offset);
+                const size_t padding_size = std::min(size - read_so_far, size_t(next_source.virtual_offset - offset));
 
                 std::memset(cur_dst, 0, padding_size);
                 read_so_far += padding_size;
@@ -17,16 +17,20 @@
 #pragma once
 #include <stratosphere.hpp>
 #include "fsmitm_romfs.hpp"
+#include "fsmitm_loose_sd_file_cache.hpp"
 
 namespace ams::mitm::fs {
 
     class LayeredRomfsStorage : public std::enable_shared_from_this<LayeredRomfsStorage>, public ams::fs::IStorage {
+        private:
+            using SourceInfoIterator = std::vector<romfs::SourceInfo>::const_iterator;
         private:
             std::vector<romfs::SourceInfo> source_infos;
             std::unique_ptr<ams::fs::IStorage> storage_romfs;
             std::unique_ptr<ams::fs::IStorage> file_romfs;
             os::Event initialize_event;
             ncm::ProgramId program_id;
+            LooseSdFileCache loose_file_cache;
             bool is_initialized;
             bool started_initialize;
         protected:
@@ -34,6 +38,8 @@ namespace ams::mitm::fs {
                 const auto &back = this->source_infos.back();
                 return back.virtual_offset + back.size;
             }
+        private:
+            SourceInfoIterator FindLastCoalescableSource(SourceInfoIterator it, s64 end_offset) const;
         public:
             LayeredRomfsStorage(std::unique_ptr<ams::fs::IStorage> s_r, std::unique_ptr<ams::fs::IStorage> f_r, ncm::ProgramId pr_id);
             virtual ~LayeredRomfsStorage();
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "../amsmitm_fs_utils.hpp"
+#include "fsmitm_loose_sd_file_cache.hpp"
+
+namespace ams::mitm::fs {
+
+    using namespace ams::fs;
+
+    namespace {
+
+        std::atomic<u64> g_cache_hits;
+        std::atomic<u64> g_cache_misses;
+        std::atomic<u64> g_cache_evictions;
+
+    }
+
+    void GetLooseSdFileCacheStatistics(LooseSdFileCacheStatistics *out) {
+        out->hits      = g_cache_hits.load();
+        out->misses    = g_cache_misses.load();
+        out->evictions = g_cache_evictions.load();
+    }
+
+    LooseSdFileCache::LooseSdFileCache(ncm::ProgramId pr_id, size_t cap) : mutex(false), entries(), mru_list(), program_id(pr_id), capacity(cap) {
+        if (this->capacity > 0) {
+            this->entries = std::unique_ptr<Entry[]>(new Entry[this->capacity]);
+
+            for (size_t i = 0; i < this->capacity; i++) {
+                this->mru_list.push_back(this->entries[i]);
+            }
+        }
+    }
+
+    LooseSdFileCache::~LooseSdFileCache() {
+        for (auto &entry : this->mru_list) {
+            AMS_ABORT_UNLESS(entry.ref_count == 0);
+            if (entry.is_open) {
+                fsFileClose(&entry.file);
+            }
+        }
+        this->mru_list.clear();
+    }
+
+    LooseSdFileCache::Entry *LooseSdFileCache::Acquire(u32 source_index) {
+        std::scoped_lock lk(this->mutex);
+
+        for (auto it = this->mru_list.begin(); it != this->mru_list.end(); ++it) {
+            if (it->is_open && it->source_index == source_index) {
+                /* Move the entry to the front of the list. */
+                Entry *entry = std::addressof(*it);
+                this->mru_list.erase(it);
+                this->mru_list.push_front(*entry);
+
+                entry->ref_count++;
+                return entry;
+            }
+        }
+
+        return nullptr;
+    }
+
+    LooseSdFileCache::Entry *LooseSdFileCache::Insert(u32 source_index, const ::FsFile &file) {
+        std::scoped_lock lk(this->mutex);
+
+        /* Find the least recently used entry that nobody is reading from. */
+        for (auto it = this->mru_list.rbegin(); it != this->mru_list.rend(); ++it) {
+            if (it->ref_count != 0) {
+                continue;
+            }
+
+            Entry *entry = std::addressof(*it);
+            if (entry->is_open) {
+                fsFileClose(&entry->file);
+                g_cache_evictions++;
+            }
+
+            entry->file         = file;
+            entry->source_index = source_index;
+            entry->ref_count    = 1;
+            entry->is_open      = true;
+
+            /* Move the entry to the front of the list. */
+            this->mru_list.erase(this->mru_list.iterator_to(*entry));
+            this->mru_list.push_front(*entry);
+
+            return entry;
+        }
+
+        return nullptr;
+    }
+
+    void LooseSdFileCache::Release(Entry *entry) {
+        std::scoped_lock lk(this->mutex);
+
+        AMS_ABORT_UNLESS(entry->ref_count > 0);
+        entry->ref_count--;
+    }
+
+    Result LooseSdFileCache::Read(u32 source_index, const char *path, s64 offset, void *buffer, size_t size) {
+        /* Try to use an already open handle. */
+        Entry *entry = this->Acquire(source_index);
+        if (entry != nullptr) {
+            g_cache_hits++;
+        } else {
+            g_cache_misses++;
+
+            /* Open the file, and try to cache the handle. */
+            FsFile file;
+            R_TRY(mitm::fs::OpenAtmosphereSdRomfsFile(&file, this->program_id, path, OpenMode_Read));
+
+            entry = this->Insert(source_index, file);
+            if (entry == nullptr) {
+                /* Every cached handle is in use (or caching is disabled), so just read without caching. */
+                ON_SCOPE_EXIT { fsFileClose(&file); };
+
+                u64 out_read = 0;
+                R_TRY(fsFileRead(&file, offset, buffer, size, FsReadOption_None, &out_read));
+                AMS_ABORT_UNLESS(out_read == size);
+                return ResultSuccess();
+            }
+        }
+        ON_SCOPE_EXIT { this->Release(entry); };
+
+        u64 out_read = 0;
+        R_TRY(fsFileRead(&entry->file, offset, buffer, size, FsReadOption_None, &out_read));
+        AMS_ABORT_UNLESS(out_read == size);
+        return ResultSuccess();
+    }
+
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::mitm::fs {
+
+    struct LooseSdFileCacheStatistics {
+        u64 hits;
+        u64 misses;
+        u64 evictions;
+    };
+    static_assert(util::is_pod<LooseSdFileCacheStatistics>::value && sizeof(LooseSdFileCacheStatistics) == 0x18);
+
+    /* Statistics are accumulated over every layered romfs storage. */
+    void GetLooseSdFileCacheStatistics(LooseSdFileCacheStatistics *out);
+
+    class LooseSdFileCache {
+        NON_COPYABLE(LooseSdFileCache);
+        NON_MOVEABLE(LooseSdFileCache);
+        private:
+            class Entry : public util::IntrusiveListBaseNode<Entry> {
+                public:
+                    ::FsFile file;
+                    u32 source_index;
+                    u32 ref_count;
+                    bool is_open;
+                public:
+                    Entry() : file(), source_index(), ref_count(), is_open() { /* ... */ }
+            };
+
+            using EntryList = util::IntrusiveListBaseTraits<Entry>::ListType;
+        private:
+            os::Mutex mutex;
+            std::unique_ptr<Entry[]> entries;
+            EntryList mru_list;
+            ncm::ProgramId program_id;
+            size_t capacity;
+        public:
+            LooseSdFileCache(ncm::ProgramId pr_id, size_t cap);
+            ~LooseSdFileCache();
+
+            Result Read(u32 source_index, const char *path, s64 offset, void *buffer, size_t size);
+        private:
+            Entry *Acquire(u32 source_index);
+            Entry *Insert(u32 source_index, const ::FsFile &file);
+            void Release(Entry *entry);
+    };
+
+}
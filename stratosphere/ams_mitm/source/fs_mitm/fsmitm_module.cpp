@@ -64,46 +64,14 @@ namespace ams::mitm::fs {
 
         os::ThreadType g_extra_threads[NumExtraThreads];
 
-        void LoopServerThread(void *arg) {
-            /* Loop forever, servicing our services. */
-            g_server_manager.LoopProcess();
-        }
-
-        void ProcessForServerOnAllThreads() {
-            /* Initialize threads. */
-            if constexpr (NumExtraThreads > 0) {
-                const s32 priority = os::GetThreadCurrentPriority(os::GetCurrentThread());
-                for (size_t i = 0; i < NumExtraThreads; i++) {
-                    R_ABORT_UNLESS(os::CreateThread(g_extra_threads + i, LoopServerThread, nullptr, g_extra_thread_stacks[i], ThreadStackSize, priority));
-                }
-            }
-
-            /* Start extra threads. */
-            if constexpr (NumExtraThreads > 0) {
-                for (size_t i = 0; i < NumExtraThreads; i++) {
-                    os::StartThread(g_extra_threads + i);
-                }
-            }
-
-            /* Loop this thread. */
-            LoopServerThread(nullptr);
-
-            /* Wait for extra threads to finish. */
-            if constexpr (NumExtraThreads > 0) {
-                for (size_t i = 0; i < NumExtraThreads; i++) {
-                    os::WaitThread(g_extra_threads + i);
-                }
-            }
-        }
-
     }
 
     void MitmModule::ThreadFunction(void *arg) {
         /* Create fs mitm. */
         R_ABORT_UNLESS((g_server_manager.RegisterMitmServer<FsMitmService>(PortIndex_Mitm, MitmServiceName)));
 
-        /* Process for the server. */
-        ProcessForServerOnAllThreads();
+        /* Process for the server on all of our threads. */
+        g_server_manager.LoopProcessMultiThreaded(g_extra_threads, g_extra_thread_stacks, ThreadStackSize, NumExtraThreads, os::GetThreadCurrentPriority(os::GetCurrentThread()));
     }
 
 }
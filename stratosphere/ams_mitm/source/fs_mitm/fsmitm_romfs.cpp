@@ -28,19 +28,8 @@ namespace ams::mitm::fs {
             constexpr u32 EmptyEntry = 0xFFFFFFFF;
             constexpr size_t FilePartitionOffset = 0x200;
 
-            struct Header {
-                s64 header_size;
-                s64 dir_hash_table_ofs;
-                s64 dir_hash_table_size;
-                s64 dir_table_ofs;
-                s64 dir_table_size;
-                s64 file_hash_table_ofs;
-                s64 file_hash_table_size;
-                s64 file_table_ofs;
-                s64 file_table_size;
-                s64 file_partition_ofs;
-            };
-            static_assert(util::is_pod<Header>::value && sizeof(Header) == 0x50);
+            constexpr size_t MaxTableCacheSize = (1_MB / 4);
+            constexpr size_t MaxHashTableWindowSize = 64_KB;
 
             struct DirectoryEntry {
                 u32 parent;
@@ -69,7 +58,7 @@ namespace ams::mitm::fs {
                 NON_COPYABLE(TableReader);
                 NON_MOVEABLE(TableReader);
                 private:
-                    static constexpr size_t MaxCachedSize = (1_MB / 4);
+                    static constexpr size_t MaxCachedSize = MaxTableCacheSize;
                     static constexpr size_t FallbackCacheSize = 1_KB;
                 private:
                     ams::fs::IStorage *storage;
@@ -129,7 +118,7 @@ namespace ams::mitm::fs {
                 NON_COPYABLE(TableWriter);
                 NON_MOVEABLE(TableWriter);
                 private:
-                    static constexpr size_t MaxCachedSize = (1_MB / 4);
+                    static constexpr size_t MaxCachedSize = MaxTableCacheSize;
                     static constexpr size_t FallbackCacheSize = 1_KB;
                 private:
                     ::FsFile *file;
@@ -257,9 +246,33 @@ namespace ams::mitm::fs {
                 }
             }
 
+            template<typename ContextSet, typename ParentOffsetGetter>
+            void WriteHashTable(::FsFile *file, size_t table_ofs, size_t num_buckets, u32 *window, size_t window_buckets, const ContextSet &contexts, ParentOffsetGetter get_parent_offset) {
+                /* Emit the hash table one window of buckets at a time, threading each entry onto its bucket's chain. */
+                /* Entries are visited in table order on every pass, so chains come out exactly as if the whole table were in memory. */
+                for (size_t window_start = 0; window_start < num_buckets; window_start += window_buckets) {
+                    const size_t cur_buckets = std::min(num_buckets - window_start, window_buckets);
+                    std::memset(window, 0xFF, cur_buckets * sizeof(u32));
+
+                    for (const auto &it : contexts) {
+                        auto *ctx = it.get();
+                        const size_t hash_ind = CalculatePathHash(get_parent_offset(ctx), ctx->path.get(), 0, ctx->path_len) % num_buckets;
+                        if (window_start <= hash_ind && hash_ind < window_start + cur_buckets) {
+                            ctx->hash_next = window[hash_ind - window_start];
+                            window[hash_ind - window_start] = ctx->entry_offset;
+                        }
+                    }
+
+                    R_ABORT_UNLESS(fsFileWrite(file, table_ofs + window_start * sizeof(u32), window, cur_buckets * sizeof(u32), FsWriteOption_None));
+                }
+            }
+
             os::Mutex g_fs_romfs_path_lock(false);
             char g_fs_romfs_path_buffer[fs::EntryNameLengthMax + 1];
 
+            os::Mutex g_build_statistics_lock(false);
+            BuildStatistics g_last_build_statistics;
+
             NOINLINE void OpenFileSystemRomfsDirectory(FsDir *out, ncm::ProgramId program_id, BuildDirectoryContext *parent, fs::OpenDirectoryMode mode, FsFileSystem *fs) {
                 std::scoped_lock lk(g_fs_romfs_path_lock);
                 parent->GetPath(g_fs_romfs_path_buffer);
@@ -268,12 +281,28 @@ namespace ams::mitm::fs {
 
         }
 
-        Builder::Builder(ncm::ProgramId pr_id) : program_id(pr_id), num_dirs(0), num_files(0), dir_table_size(0), file_table_size(0), dir_hash_table_size(0), file_hash_table_size(0), file_partition_size(0) {
+        void GetLastBuildStatistics(BuildStatistics *out) {
+            std::scoped_lock lk(g_build_statistics_lock);
+            *out = g_last_build_statistics;
+        }
+
+        Builder::Builder(ncm::ProgramId pr_id) : program_id(pr_id), num_dirs(0), num_files(0), dir_table_size(0), file_table_size(0), dir_hash_table_size(0), file_hash_table_size(0), file_partition_size(0), memory_usage(0), peak_memory_usage(0) {
             auto res = this->directories.emplace(std::make_unique<BuildDirectoryContext>(BuildDirectoryContext::RootTag{}));
             AMS_ABORT_UNLESS(res.second);
             this->root = res.first->get();
             this->num_dirs = 1;
             this->dir_table_size = 0x18;
+            this->AddMemoryUsage(sizeof(BuildDirectoryContext) + 1);
+        }
+
+        void Builder::AddMemoryUsage(size_t size) {
+            this->memory_usage += size;
+            this->peak_memory_usage = std::max(this->peak_memory_usage, this->memory_usage);
+        }
+
+        void Builder::RemoveMemoryUsage(size_t size) {
+            AMS_ABORT_UNLESS(this->memory_usage >= size);
+            this->memory_usage -= size;
         }
 
         void Builder::AddDirectory(BuildDirectoryContext **out, BuildDirectoryContext *parent_ctx, std::unique_ptr<BuildDirectoryContext> child_ctx) {
@@ -290,6 +319,7 @@ namespace ams::mitm::fs {
             /* Add a new directory. */
             this->num_dirs++;
             this->dir_table_size += sizeof(DirectoryEntry) + util::AlignUp(child_ctx->path_len, 4);
+            this->AddMemoryUsage(sizeof(BuildDirectoryContext) + child_ctx->path_len + 1);
 
             *out = child_ctx.get();
             this->directories.emplace(std::move(child_ctx));
@@ -307,6 +337,7 @@ namespace ams::mitm::fs {
             /* Add a new file. */
             this->num_files++;
             this->file_table_size += sizeof(FileEntry) + util::AlignUp(file_ctx->path_len, 4);
+            this->AddMemoryUsage(sizeof(BuildFileContext) + file_ctx->path_len + 1);
             this->files.emplace(std::move(file_ctx));
         }
 
@@ -324,8 +355,12 @@ namespace ams::mitm::fs {
 
             {
                 BuildDirectoryContext **child_dirs = reinterpret_cast<BuildDirectoryContext **>(std::malloc(sizeof(BuildDirectoryContext *) * num_child_dirs));
-                ON_SCOPE_EXIT { std::free(child_dirs); };
                 AMS_ABORT_UNLESS(child_dirs != nullptr);
+                this->AddMemoryUsage(sizeof(BuildDirectoryContext *) * num_child_dirs);
+                ON_SCOPE_EXIT {
+                    std::free(child_dirs);
+                    this->RemoveMemoryUsage(sizeof(BuildDirectoryContext *) * num_child_dirs);
+                };
                 s64 cur_child_dir_ind = 0;
 
                 {
@@ -431,6 +466,10 @@ namespace ams::mitm::fs {
             DirectoryTableReader dir_table(storage, header.dir_table_ofs, header.dir_table_size);
             FileTableReader file_table(storage, header.file_table_ofs, header.file_table_size);
 
+            const size_t table_cache_size = std::min<size_t>(header.dir_table_size, MaxTableCacheSize) + std::min<size_t>(header.file_table_size, MaxTableCacheSize);
+            this->AddMemoryUsage(table_cache_size);
+            ON_SCOPE_EXIT { this->RemoveMemoryUsage(table_cache_size); };
+
             this->cur_source_type = source_type;
             this->VisitDirectory(this->root, 0x0, dir_table, file_table);
         }
@@ -452,7 +491,20 @@ namespace ams::mitm::fs {
 
             /* Allocate metadata, make pointers. */
             Header *header = reinterpret_cast<Header *>(std::malloc(sizeof(Header)));
+            AMS_ABORT_UNLESS(header != nullptr);
             std::memset(header, 0x00, sizeof(*header));
+            this->AddMemoryUsage(sizeof(*header));
+
+            /* Allocate a bounded window for emitting hash tables. */
+            const size_t hash_table_window_size = std::min(std::max(this->dir_hash_table_size, this->file_hash_table_size), MaxHashTableWindowSize);
+            const size_t hash_table_window_buckets = hash_table_window_size / sizeof(u32);
+            u32 *hash_table_window = reinterpret_cast<u32 *>(std::malloc(hash_table_window_size));
+            AMS_ABORT_UNLESS(hash_table_window != nullptr);
+            this->AddMemoryUsage(hash_table_window_size);
+            ON_SCOPE_EXIT {
+                std::free(hash_table_window);
+                this->RemoveMemoryUsage(hash_table_window_size);
+            };
 
             /* Open metadata file. */
             const size_t metadata_size = this->dir_hash_table_size + this->dir_table_size + this->file_hash_table_size + this->file_table_size;
@@ -525,18 +577,17 @@ namespace ams::mitm::fs {
 
             /* Populate file tables. */
             {
-                /* Allocate the hash table. */
-                void *fht_buf = std::malloc(this->file_hash_table_size);
-                AMS_ABORT_UNLESS(fht_buf != nullptr);
-                u32 *file_hash_table = reinterpret_cast<u32 *>(fht_buf);
-                std::memset(file_hash_table, 0xFF, this->file_hash_table_size);
-                ON_SCOPE_EXIT {
-                    R_ABORT_UNLESS(fsFileWrite(&metadata_file, this->dir_hash_table_size + this->dir_table_size, file_hash_table, this->file_hash_table_size, FsWriteOption_None));
-                    std::free(fht_buf);
-                };
+                /* Write the hash table. */
+                WriteHashTable(&metadata_file, this->dir_hash_table_size + this->dir_table_size, num_file_hash_table_entries, hash_table_window, hash_table_window_buckets, this->files, [](const BuildFileContext *ctx) -> u32 {
+                    return ctx->parent->entry_offset;
+                });
 
                 /* Write the file table. */
                 {
+                    const size_t table_cache_size = std::min(this->file_table_size, MaxTableCacheSize);
+                    this->AddMemoryUsage(table_cache_size);
+                    ON_SCOPE_EXIT { this->RemoveMemoryUsage(table_cache_size); };
+
                     FileTableWriter file_table(&metadata_file, this->dir_hash_table_size + this->dir_table_size + this->file_hash_table_size, this->file_table_size);
 
                     for (const auto &it : this->files) {
@@ -549,11 +600,9 @@ namespace ams::mitm::fs {
                         cur_entry->offset = cur_file->offset;
                         cur_entry->size = cur_file->size;
 
-                        /* Insert into hash table. */
+                        /* Link into hash table. */
                         const u32 name_size = cur_file->path_len;
-                        const size_t hash_ind = CalculatePathHash(cur_entry->parent, cur_file->path.get(), 0, name_size) % num_file_hash_table_entries;
-                        cur_entry->hash = file_hash_table[hash_ind];
-                        file_hash_table[hash_ind] = cur_file->entry_offset;
+                        cur_entry->hash = cur_file->hash_next;
 
                         /* Set name. */
                         cur_entry->name_size = name_size;
@@ -593,18 +642,17 @@ namespace ams::mitm::fs {
 
             /* Populate directory tables. */
             {
-                /* Allocate the hash table. */
-                void *dht_buf = std::malloc(this->dir_hash_table_size);
-                AMS_ABORT_UNLESS(dht_buf != nullptr);
-                u32 *dir_hash_table = reinterpret_cast<u32 *>(dht_buf);
-                std::memset(dir_hash_table, 0xFF, this->dir_hash_table_size);
-                ON_SCOPE_EXIT {
-                    R_ABORT_UNLESS(fsFileWrite(&metadata_file, 0, dir_hash_table, this->dir_hash_table_size, FsWriteOption_None));
-                    std::free(dht_buf);
-                };
+                /* Write the hash table. */
+                WriteHashTable(&metadata_file, 0, num_dir_hash_table_entries, hash_table_window, hash_table_window_buckets, this->directories, [&](const BuildDirectoryContext *ctx) -> u32 {
+                    return ctx == this->root ? 0 : ctx->parent->entry_offset;
+                });
 
-                /* Write the file table. */
+                /* Write the directory table. */
                 {
+                    const size_t table_cache_size = std::min(this->dir_table_size, MaxTableCacheSize);
+                    this->AddMemoryUsage(table_cache_size);
+                    ON_SCOPE_EXIT { this->RemoveMemoryUsage(table_cache_size); };
+
                     DirectoryTableWriter dir_table(&metadata_file, this->dir_hash_table_size, this->dir_table_size);
 
                     for (const auto &it : this->directories) {
@@ -617,11 +665,9 @@ namespace ams::mitm::fs {
                         cur_entry->child   = (cur_dir->child   == nullptr) ? EmptyEntry : cur_dir->child->entry_offset;
                         cur_entry->file    = (cur_dir->file    == nullptr) ? EmptyEntry : cur_dir->file->entry_offset;
 
-                        /* Insert into hash table. */
+                        /* Link into hash table. */
                         const u32 name_size = cur_dir->path_len;
-                        const size_t hash_ind = CalculatePathHash(cur_entry->parent, cur_dir->path.get(), 0, name_size) % num_dir_hash_table_entries;
-                        cur_entry->hash = dir_hash_table[hash_ind];
-                        dir_hash_table[hash_ind] = cur_dir->entry_offset;
+                        cur_entry->hash = cur_dir->hash_next;
 
                         /* Set name. */
                         cur_entry->name_size = name_size;
@@ -635,6 +681,18 @@ namespace ams::mitm::fs {
                 }
             }
 
+            /* Record build statistics. */
+            {
+                std::scoped_lock lk(g_build_statistics_lock);
+                g_last_build_statistics = {
+                    .program_id        = this->program_id,
+                    .num_dirs          = this->num_dirs,
+                    .num_files         = this->num_files,
+                    .metadata_size     = metadata_size,
+                    .peak_memory_usage = this->peak_memory_usage,
+                };
+            }
+
             /* Delete maps. */
             this->root = nullptr;
             this->directories.clear();
@@ -19,6 +19,20 @@
 
 namespace ams::mitm::fs::romfs {
 
+    struct Header {
+        s64 header_size;
+        s64 dir_hash_table_ofs;
+        s64 dir_hash_table_size;
+        s64 dir_table_ofs;
+        s64 dir_table_size;
+        s64 file_hash_table_ofs;
+        s64 file_hash_table_size;
+        s64 file_table_ofs;
+        s64 file_table_size;
+        s64 file_partition_ofs;
+    };
+    static_assert(util::is_pod<Header>::value && sizeof(Header) == 0x50);
+
     enum class DataSourceType {
         Storage,
         File,
@@ -120,14 +134,15 @@ namespace ams::mitm::fs::romfs {
         BuildFileContext *file;
         u32 path_len;
         u32 entry_offset;
+        u32 hash_next;
 
         struct RootTag{};
 
-        BuildDirectoryContext(RootTag) : parent(nullptr), child(nullptr), sibling(nullptr), file(nullptr), path_len(0), entry_offset(0) {
+        BuildDirectoryContext(RootTag) : parent(nullptr), child(nullptr), sibling(nullptr), file(nullptr), path_len(0), entry_offset(0), hash_next(0) {
             this->path = std::make_unique<char[]>(1);
         }
 
-        BuildDirectoryContext(const char *entry_name, size_t entry_name_len) : parent(nullptr), child(nullptr), sibling(nullptr), file(nullptr), entry_offset(0) {
+        BuildDirectoryContext(const char *entry_name, size_t entry_name_len) : parent(nullptr), child(nullptr), sibling(nullptr), file(nullptr), entry_offset(0), hash_next(0) {
             this->path_len = entry_name_len;
             this->path = std::unique_ptr<char[]>(new char[this->path_len + 1]);
             std::memcpy(this->path.get(), entry_name, entry_name_len);
@@ -168,9 +183,10 @@ namespace ams::mitm::fs::romfs {
         s64 orig_offset;
         u32 path_len;
         u32 entry_offset;
+        u32 hash_next;
         DataSourceType source_type;
 
-        BuildFileContext(const char *entry_name, size_t entry_name_len, s64 sz, s64 o_o, DataSourceType type) : parent(nullptr), sibling(nullptr), offset(0), size(sz), orig_offset(o_o), entry_offset(0), source_type(type) {
+        BuildFileContext(const char *entry_name, size_t entry_name_len, s64 sz, s64 o_o, DataSourceType type) : parent(nullptr), sibling(nullptr), offset(0), size(sz), orig_offset(o_o), entry_offset(0), hash_next(0), source_type(type) {
             this->path_len = entry_name_len;
             this->path = std::unique_ptr<char[]>(new char[this->path_len + 1]);
             std::memcpy(this->path.get(), entry_name, entry_name_len);
@@ -199,6 +215,17 @@ namespace ams::mitm::fs::romfs {
         }
     };
 
+    struct BuildStatistics {
+        ncm::ProgramId program_id;
+        u64 num_dirs;
+        u64 num_files;
+        u64 metadata_size;
+        u64 peak_memory_usage;
+    };
+    static_assert(util::is_pod<BuildStatistics>::value && sizeof(BuildStatistics) == 0x28);
+
+    void GetLastBuildStatistics(BuildStatistics *out);
+
     class DirectoryTableReader;
     class FileTableReader;
 
@@ -241,6 +268,8 @@ namespace ams::mitm::fs::romfs {
             size_t dir_hash_table_size;
             size_t file_hash_table_size;
             size_t file_partition_size;
+            size_t memory_usage;
+            size_t peak_memory_usage;
 
             ams::fs::DirectoryEntry dir_entry;
             DataSourceType cur_source_type;
@@ -250,6 +279,9 @@ namespace ams::mitm::fs::romfs {
 
             void AddDirectory(BuildDirectoryContext **out, BuildDirectoryContext *parent_ctx, std::unique_ptr<BuildDirectoryContext> file_ctx);
             void AddFile(BuildDirectoryContext *parent_ctx, std::unique_ptr<BuildFileContext> file_ctx);
+
+            void AddMemoryUsage(size_t size);
+            void RemoveMemoryUsage(size_t size);
         public:
             Builder(ncm::ProgramId pr_id);
 
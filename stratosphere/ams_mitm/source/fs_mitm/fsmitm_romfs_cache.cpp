@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "../amsmitm_fs_utils.hpp"
+#include "fsmitm_romfs_cache.hpp"
+
+namespace ams::mitm::fs {
+
+    using namespace ams::fs;
+
+    namespace romfs {
+
+        namespace {
+
+            constexpr inline const char CacheFileName[]    = "romfs_cache.bin";
+            constexpr inline const char MetadataFileName[] = "romfs_metadata.bin";
+
+            constexpr size_t WorkBufferSize = 0x8000;
+            constexpr size_t DirectoryEntryBufferCount = WorkBufferSize / sizeof(DirectoryEntry);
+            static_assert(DirectoryEntryBufferCount > 0);
+
+            struct CacheHeader {
+                static constexpr u32 Magic   = util::FourCC<'R','F','S','C'>::Code;
+                static constexpr u32 Version = 0;
+
+                u32 magic;
+                u32 version;
+                u8 fingerprint[sizeof(CacheFingerprint::hash)];
+                u32 num_infos;
+                u32 reserved;
+                s64 metadata_size;
+                u64 data_size;
+            };
+            static_assert(util::is_pod<CacheHeader>::value && sizeof(CacheHeader) == 0x40);
+
+            struct CacheEntry {
+                s64 virtual_offset;
+                s64 size;
+                u64 value;
+                u32 source_type;
+                u32 data_size;
+            };
+            static_assert(util::is_pod<CacheEntry>::value && sizeof(CacheEntry) == 0x20);
+
+            struct FingerprintContext {
+                crypto::Sha256Generator generator;
+                void *work_buffer;
+                char path[ams::fs::EntryNameLengthMax + 1];
+            };
+
+            void UpdateFingerprintWithSdDirectory(FingerprintContext *ctx, ncm::ProgramId program_id, size_t path_len) {
+                /* Hash all entries, remembering the names of child directories. */
+                /* Loose files are opened by path at read time, so only names and sizes affect the built romfs. */
+                std::vector<char> child_names;
+                {
+                    FsDir dir;
+                    R_ABORT_UNLESS(mitm::fs::OpenAtmosphereSdRomfsDirectory(&dir, program_id, ctx->path, OpenDirectoryMode_All));
+                    ON_SCOPE_EXIT { fsDirClose(&dir); };
+
+                    DirectoryEntry *entries = static_cast<DirectoryEntry *>(ctx->work_buffer);
+                    while (true) {
+                        s64 read_entries = 0;
+                        R_ABORT_UNLESS(fsDirRead(&dir, &read_entries, DirectoryEntryBufferCount, entries));
+                        if (read_entries <= 0) {
+                            break;
+                        }
+
+                        for (s64 i = 0; i < read_entries; i++) {
+                            const auto &entry = entries[i];
+                            const size_t name_len = strnlen(entry.name, sizeof(entry.name));
+                            AMS_ABORT_UNLESS(name_len < sizeof(entry.name));
+
+                            ctx->generator.Update(entry.name, name_len + 1);
+                            ctx->generator.Update(&entry.type, sizeof(entry.type));
+                            ctx->generator.Update(&entry.file_size, sizeof(entry.file_size));
+
+                            if (entry.type == FsDirEntryType_Dir) {
+                                child_names.insert(child_names.end(), entry.name, entry.name + name_len + 1);
+                            }
+                        }
+                    }
+                }
+
+                /* Mark the end of the directory, so that moving entries between directories changes the fingerprint. */
+                const u8 end_marker = 0xFF;
+                ctx->generator.Update(&end_marker, sizeof(end_marker));
+
+                /* Visit child directories. */
+                for (size_t ofs = 0; ofs < child_names.size(); /* ... */) {
+                    const char *name = child_names.data() + ofs;
+                    const size_t name_len = std::strlen(name);
+                    ofs += name_len + 1;
+
+                    AMS_ABORT_UNLESS(path_len + 1 + name_len < sizeof(ctx->path));
+                    ctx->path[path_len] = '/';
+                    std::memcpy(ctx->path + path_len + 1, name, name_len + 1);
+
+                    UpdateFingerprintWithSdDirectory(ctx, program_id, path_len + 1 + name_len);
+                }
+                ctx->path[path_len] = '\x00';
+            }
+
+            void UpdateFingerprintWithStorageRange(FingerprintContext *ctx, ams::fs::IStorage *storage, s64 offset, s64 size) {
+                while (size > 0) {
+                    const size_t cur_size = static_cast<size_t>(std::min<s64>(size, WorkBufferSize));
+                    R_ABORT_UNLESS(storage->Read(offset, ctx->work_buffer, cur_size));
+                    ctx->generator.Update(ctx->work_buffer, cur_size);
+
+                    offset += cur_size;
+                    size   -= cur_size;
+                }
+            }
+
+            void UpdateFingerprintWithStorage(FingerprintContext *ctx, ams::fs::IStorage *storage) {
+                /* Note whether the storage is present at all. */
+                const u8 present = storage != nullptr;
+                ctx->generator.Update(&present, sizeof(present));
+                if (storage == nullptr) {
+                    return;
+                }
+
+                /* Hash the storage size and header. */
+                s64 storage_size = 0;
+                R_ABORT_UNLESS(storage->GetSize(&storage_size));
+                ctx->generator.Update(&storage_size, sizeof(storage_size));
+
+                Header header;
+                R_ABORT_UNLESS(storage->Read(0, &header, sizeof(header)));
+                AMS_ABORT_UNLESS(header.header_size == sizeof(Header));
+                ctx->generator.Update(&header, sizeof(header));
+
+                /* The directory and file tables fully determine what the builder visits, so hash those as well. */
+                UpdateFingerprintWithStorageRange(ctx, storage, header.dir_table_ofs,  header.dir_table_size);
+                UpdateFingerprintWithStorageRange(ctx, storage, header.file_table_ofs, header.file_table_size);
+            }
+
+            bool TryLoadSourceInfos(std::vector<SourceInfo> *out_infos, FsFile *cache_file, ncm::ProgramId program_id, const CacheFingerprint &fingerprint) {
+                /* Read the whole cache. */
+                s64 cache_size = 0;
+                if (R_FAILED(fsFileGetSize(cache_file, &cache_size)) || cache_size < static_cast<s64>(sizeof(CacheHeader))) {
+                    return false;
+                }
+
+                void *cache = std::malloc(cache_size);
+                if (cache == nullptr) {
+                    return false;
+                }
+                ON_SCOPE_EXIT { std::free(cache); };
+
+                u64 read_size = 0;
+                if (R_FAILED(fsFileRead(cache_file, 0, cache, cache_size, FsReadOption_None, &read_size)) || read_size != static_cast<u64>(cache_size)) {
+                    return false;
+                }
+
+                /* Validate the header. */
+                const CacheHeader *header = static_cast<const CacheHeader *>(cache);
+                if (header->magic != CacheHeader::Magic || header->version != CacheHeader::Version) {
+                    return false;
+                }
+                if (!crypto::IsSameBytes(header->fingerprint, fingerprint.hash, sizeof(fingerprint.hash))) {
+                    return false;
+                }
+                if (sizeof(CacheHeader) + header->num_infos * sizeof(CacheEntry) + header->data_size != static_cast<u64>(cache_size)) {
+                    return false;
+                }
+
+                const CacheEntry *entries = reinterpret_cast<const CacheEntry *>(header + 1);
+                const u8 *data = reinterpret_cast<const u8 *>(entries + header->num_infos);
+
+                /* Open the metadata emitted by the build that produced this cache. */
+                FsFile metadata_file;
+                if (R_FAILED(mitm::fs::OpenAtmosphereSdFile(&metadata_file, program_id, MetadataFileName, OpenMode_Read))) {
+                    return false;
+                }
+                auto metadata_guard = SCOPE_GUARD { fsFileClose(&metadata_file); };
+
+                s64 metadata_size = 0;
+                if (R_FAILED(fsFileGetSize(&metadata_file, &metadata_size)) || metadata_size != header->metadata_size) {
+                    return false;
+                }
+
+                /* Reconstruct the source infos. */
+                auto infos_guard = SCOPE_GUARD {
+                    for (auto &info : *out_infos) {
+                        info.Cleanup();
+                    }
+                    out_infos->clear();
+                };
+
+                out_infos->reserve(header->num_infos);
+
+                bool has_metadata = false;
+                for (u32 i = 0; i < header->num_infos; i++) {
+                    const auto &entry = entries[i];
+                    const auto source_type = static_cast<DataSourceType>(entry.source_type);
+
+                    switch (source_type) {
+                        case DataSourceType::Storage:
+                        case DataSourceType::File:
+                            out_infos->emplace_back(entry.virtual_offset, entry.size, source_type, static_cast<s64>(entry.value));
+                            break;
+                        case DataSourceType::LooseSdFile:
+                            {
+                                if (entry.data_size == 0 || entry.value > header->data_size || entry.data_size > header->data_size - entry.value) {
+                                    return false;
+                                }
+
+                                const char *src_path = reinterpret_cast<const char *>(data + entry.value);
+                                if (src_path[entry.data_size - 1] != '\x00') {
+                                    return false;
+                                }
+
+                                char *new_path = new char[entry.data_size];
+                                std::memcpy(new_path, src_path, entry.data_size);
+                                out_infos->emplace_back(entry.virtual_offset, entry.size, source_type, new_path);
+                            }
+                            break;
+                        case DataSourceType::Memory:
+                            {
+                                if (entry.data_size != entry.size || entry.value > header->data_size || entry.data_size > header->data_size - entry.value) {
+                                    return false;
+                                }
+
+                                void *mem = std::malloc(entry.data_size);
+                                if (mem == nullptr) {
+                                    return false;
+                                }
+
+                                std::memcpy(mem, data + entry.value, entry.data_size);
+                                out_infos->emplace_back(entry.virtual_offset, entry.size, source_type, mem);
+                            }
+                            break;
+                        case DataSourceType::Metadata:
+                            {
+                                if (has_metadata || entry.size != metadata_size) {
+                                    return false;
+                                }
+
+                                out_infos->emplace_back(entry.virtual_offset, entry.size, source_type, new RemoteFile(metadata_file));
+                                metadata_guard.Cancel();
+                                has_metadata = true;
+                            }
+                            break;
+                        default:
+                            return false;
+                    }
+                }
+
+                if (!has_metadata) {
+                    return false;
+                }
+
+                infos_guard.Cancel();
+                return true;
+            }
+
+        }
+
+        void CalculateCacheFingerprint(CacheFingerprint *out, ncm::ProgramId program_id, bool use_sd, ams::fs::IStorage *file_romfs, ams::fs::IStorage *storage_romfs) {
+            auto ctx = std::make_unique<FingerprintContext>();
+            AMS_ABORT_UNLESS(ctx != nullptr);
+
+            ctx->work_buffer = std::malloc(WorkBufferSize);
+            AMS_ABORT_UNLESS(ctx->work_buffer != nullptr);
+            ON_SCOPE_EXIT { std::free(ctx->work_buffer); };
+
+            ctx->generator.Initialize();
+
+            /* Hash the loose SD files, if there are any. */
+            {
+                FsDir dir;
+                const bool has_sd_romfs = use_sd && R_SUCCEEDED(mitm::fs::OpenAtmosphereSdRomfsDirectory(&dir, program_id, "", OpenDirectoryMode_Directory));
+
+                const u8 present = has_sd_romfs;
+                ctx->generator.Update(&present, sizeof(present));
+
+                if (has_sd_romfs) {
+                    fsDirClose(&dir);
+
+                    ctx->path[0] = '\x00';
+                    UpdateFingerprintWithSdDirectory(ctx.get(), program_id, 0);
+                }
+            }
+
+            /* Hash the romfs images, in the order the builder adds them. */
+            UpdateFingerprintWithStorage(ctx.get(), file_romfs);
+            UpdateFingerprintWithStorage(ctx.get(), storage_romfs);
+
+            ctx->generator.GetHash(out->hash, sizeof(out->hash));
+        }
+
+        bool LoadSourceInfosFromCache(std::vector<SourceInfo> *out_infos, ncm::ProgramId program_id, const CacheFingerprint &fingerprint) {
+            /* Clear output. */
+            out_infos->clear();
+
+            /* Open the cache, if there is one. */
+            FsFile cache_file;
+            if (R_FAILED(mitm::fs::OpenAtmosphereSdFile(&cache_file, program_id, CacheFileName, OpenMode_Read))) {
+                return false;
+            }
+
+            bool loaded = false;
+            {
+                ON_SCOPE_EXIT { fsFileClose(&cache_file); };
+                loaded = TryLoadSourceInfos(out_infos, &cache_file, program_id, fingerprint);
+            }
+
+            /* A stale cache must not outlive the metadata it describes, which is about to be rebuilt. */
+            if (!loaded) {
+                mitm::fs::DeleteAtmosphereSdFile(program_id, CacheFileName);
+            }
+
+            return loaded;
+        }
+
+        void SaveSourceInfosToCache(const std::vector<SourceInfo> &infos, ncm::ProgramId program_id, const CacheFingerprint &fingerprint) {
+            /* Determine the cache size. */
+            size_t data_size = 0;
+            s64 metadata_size = -1;
+            for (const auto &info : infos) {
+                switch (info.source_type) {
+                    case DataSourceType::Storage:
+                    case DataSourceType::File:
+                        break;
+                    case DataSourceType::LooseSdFile:
+                        data_size += std::strlen(info.loose_source_info.path) + 1;
+                        break;
+                    case DataSourceType::Memory:
+                        data_size += info.size;
+                        break;
+                    case DataSourceType::Metadata:
+                        metadata_size = info.size;
+                        break;
+                    AMS_UNREACHABLE_DEFAULT_CASE();
+                }
+            }
+            AMS_ABORT_UNLESS(metadata_size >= 0);
+
+            const size_t cache_size = sizeof(CacheHeader) + infos.size() * sizeof(CacheEntry) + data_size;
+
+            /* Caching is best-effort, so failing to allocate just means the next launch rebuilds. */
+            void *cache = std::malloc(cache_size);
+            if (cache == nullptr) {
+                return;
+            }
+            ON_SCOPE_EXIT { std::free(cache); };
+
+            /* Serialize the header. */
+            CacheHeader *header = static_cast<CacheHeader *>(cache);
+            std::memset(header, 0, sizeof(*header));
+            header->magic         = CacheHeader::Magic;
+            header->version       = CacheHeader::Version;
+            header->num_infos     = static_cast<u32>(infos.size());
+            header->metadata_size = metadata_size;
+            header->data_size     = data_size;
+            std::memcpy(header->fingerprint, fingerprint.hash, sizeof(header->fingerprint));
+
+            /* Serialize the source infos. */
+            CacheEntry *entries = reinterpret_cast<CacheEntry *>(header + 1);
+            u8 *data = reinterpret_cast<u8 *>(entries + infos.size());
+            size_t data_offset = 0;
+            for (size_t i = 0; i < infos.size(); i++) {
+                const auto &info = infos[i];
+                auto &entry = entries[i];
+
+                entry.virtual_offset = info.virtual_offset;
+                entry.size           = info.size;
+                entry.value          = 0;
+                entry.source_type    = static_cast<u32>(info.source_type);
+                entry.data_size      = 0;
+
+                switch (info.source_type) {
+                    case DataSourceType::Storage:
+                        entry.value = info.storage_source_info.offset;
+                        break;
+                    case DataSourceType::File:
+                        entry.value = info.file_source_info.offset;
+                        break;
+                    case DataSourceType::LooseSdFile:
+                        {
+                            const size_t path_size = std::strlen(info.loose_source_info.path) + 1;
+                            std::memcpy(data + data_offset, info.loose_source_info.path, path_size);
+                            entry.value     = data_offset;
+                            entry.data_size = path_size;
+                            data_offset    += path_size;
+                        }
+                        break;
+                    case DataSourceType::Memory:
+                        std::memcpy(data + data_offset, info.memory_source_info.data, info.size);
+                        entry.value     = data_offset;
+                        entry.data_size = info.size;
+                        data_offset    += info.size;
+                        break;
+                    case DataSourceType::Metadata:
+                        break;
+                    AMS_UNREACHABLE_DEFAULT_CASE();
+                }
+            }
+            AMS_ABORT_UNLESS(data_offset == data_size);
+
+            /* Save the cache to the SD card. */
+            FsFile cache_file;
+            if (R_SUCCEEDED(mitm::fs::SaveAtmosphereSdFile(&cache_file, program_id, CacheFileName, cache, cache_size))) {
+                fsFileClose(&cache_file);
+            }
+        }
+
+    }
+
+}
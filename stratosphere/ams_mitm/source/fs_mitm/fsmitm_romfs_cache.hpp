@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <stratosphere.hpp>
+#include "fsmitm_romfs.hpp"
+
+namespace ams::mitm::fs::romfs {
+
+    struct CacheFingerprint {
+        u8 hash[crypto::Sha256Generator::HashSize];
+    };
+
+    /* Fingerprints everything a built romfs depends on: the loose SD tree's names/sizes, and the base romfs tables. */
+    void CalculateCacheFingerprint(CacheFingerprint *out, ncm::ProgramId program_id, bool use_sd, ams::fs::IStorage *file_romfs, ams::fs::IStorage *storage_romfs);
+
+    /* Loads source infos saved by a previous build, if the fingerprint matches. Stale caches are deleted. */
+    bool LoadSourceInfosFromCache(std::vector<SourceInfo> *out_infos, ncm::ProgramId program_id, const CacheFingerprint &fingerprint);
+    void SaveSourceInfosToCache(const std::vector<SourceInfo> &infos, ncm::ProgramId program_id, const CacheFingerprint &fingerprint);
+
+}
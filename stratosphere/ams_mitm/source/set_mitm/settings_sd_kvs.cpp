@@ -337,6 +337,10 @@ namespace ams::settings::fwdbg {
             /* 0 = only save toggles if toggle file exists. */
             R_ABORT_UNLESS(ParseSettingsItemValue("atmosphere", "dmnt_always_save_cheat_toggles", "u8!0x0"));
 
+            /* Controls how many times per second dmnt runs cheats */
+            /* and re-applies frozen addresses. Capped at 1000. */
+            R_ABORT_UNLESS(ParseSettingsItemValue("atmosphere", "dmnt_cheat_vm_ticks_per_second", "u32!0xC"));
+
             /* Controls whether fs.mitm should redirect save files */
             /* to directories on the sd card. */
             /* 0 = Do not redirect, 1 = Redirect. */
@@ -344,6 +348,11 @@ namespace ams::settings::fwdbg {
             /* If you do not know what you are doing, do not touch this yet. */
             R_ABORT_UNLESS(ParseSettingsItemValue("atmosphere", "fsmitm_redirect_saves_to_sd", "u8!0x0"));
 
+            /* Controls how many loose sd card romfs files fs.mitm keeps open per layered romfs, */
+            /* to avoid reopening files that are read from repeatedly. */
+            /* 0 = Do not keep files open. */
+            R_ABORT_UNLESS(ParseSettingsItemValue("atmosphere", "fsmitm_romfs_file_cache_count", "u32!0x8"));
+
             /* Controls whether am sees system settings "DebugModeFlag" as */
             /* enabled or disabled. */
             /* 0 = Disabled (not debug mode), 1 = Enabled (debug mode) */
@@ -302,24 +302,34 @@ namespace ams::creport {
         {
             char file_path[fs::EntryNameLengthMax + 1];
 
+            /* Allocate a cache, so that we don't write each line of the report separately. */
+            /* NOTE: If allocation fails, files will simply be written without a cache. */
+            void *file_cache = lmem::AllocateFromExpHeap(this->heap_handle, FileCacheSize);
+            const size_t file_cache_size = file_cache != nullptr ? FileCacheSize : 0;
+
             /* Save crash report. */
             util::SNPrintf(file_path, sizeof(file_path), "sdmc:/atmosphere/crash_reports/%011lu_%016lx.log", timestamp, this->process_info.program_id);
             {
-                ScopedFile file(file_path);
+                ScopedFile file(file_path, file_cache, file_cache_size);
                 if (file.IsOpen()) {
                     this->SaveToFile(file);
                 }
             }
 
-            /* Dump threads. */
+            /* Dump threads and modules. */
             util::SNPrintf(file_path, sizeof(file_path), "sdmc:/atmosphere/crash_reports/dumps/%011lu_%016lx_thread_info.bin", timestamp, this->process_info.program_id);
             {
-                ScopedFile file(file_path);
+                ScopedFile file(file_path, file_cache, file_cache_size);
                 if (file.IsOpen()) {
                     this->thread_list->DumpBinary(file, this->crashed_thread.GetThreadId());
+                    this->module_list->DumpBinary(file);
                 }
             }
 
+            if (file_cache != nullptr) {
+                lmem::FreeToExpHeap(this->heap_handle, file_cache);
+            }
+
             /* Finalize our heap. */
             this->module_list->~ModuleList();
             this->thread_list->~ThreadList();
@@ -22,8 +22,9 @@ namespace ams::creport {
     class CrashReport {
         private:
             static constexpr size_t DyingMessageSizeMax = os::MemoryPageSize;
+            static constexpr size_t FileCacheSize = 64_KB;
             static constexpr size_t MemoryHeapSize = 512_KB;
-            static_assert(MemoryHeapSize >= DyingMessageSizeMax + sizeof(ModuleList) + sizeof(ThreadList) + os::MemoryPageSize);
+            static_assert(MemoryHeapSize >= DyingMessageSizeMax + sizeof(ModuleList) + sizeof(ThreadList) + FileCacheSize + os::MemoryPageSize);
         private:
             Handle debug_handle = INVALID_HANDLE;
             bool has_extra_info = true;
@@ -23,6 +23,7 @@ namespace ams::creport {
 
         /* Convenience definitions/types. */
         constexpr size_t ModulePathLengthMax = 0x200;
+        constexpr u32 DumpedModuleInfoMagic = util::FourCC<'D','M','I','1'>::Code;
         constexpr u8 GnuSignature[4] = {'G', 'N', 'U', 0};
 
         struct ModulePath {
@@ -58,6 +59,20 @@ namespace ams::creport {
         }
     }
 
+    void ModuleList::DumpBinary(ScopedFile &file) {
+        const u32 magic = DumpedModuleInfoMagic;
+        const u32 count = this->num_modules;
+        file.Write(&magic, sizeof(magic));
+        file.Write(&count, sizeof(count));
+        for (size_t i = 0; i < this->num_modules; i++) {
+            const auto& module = this->modules[i];
+            file.Write(&module.name, sizeof(module.name));
+            file.Write(&module.build_id, sizeof(module.build_id));
+            file.Write(&module.start_address, sizeof(module.start_address));
+            file.Write(&module.end_address, sizeof(module.end_address));
+        }
+    }
+
     void ModuleList::FindModulesFromThreadInfo(Handle debug_handle, const ThreadInfo &thread) {
         /* Set the debug handle, for access in other member functions. */
         this->debug_handle = debug_handle;
@@ -54,6 +54,7 @@ namespace ams::creport {
             void FindModulesFromThreadInfo(Handle debug_handle, const ThreadInfo &thread);
             const char *GetFormattedAddressString(uintptr_t address);
             void SaveToFile(ScopedFile &file);
+            void DumpBinary(ScopedFile &file);
         private:
             bool TryFindModule(uintptr_t *out_address, uintptr_t guess);
             void TryAddModule(uintptr_t guess);
@@ -22,6 +22,7 @@ namespace ams::creport {
 
         /* Convenience definitions. */
         constexpr size_t MaximumLineLength = 0x20;
+        constexpr const char HexDigits[] = "0123456789ABCDEF";
 
         os::Mutex g_format_lock(false);
         char g_format_buffer[2 * os::MemoryPageSize];
@@ -70,7 +71,9 @@ namespace ams::creport {
             {
                 char hex[MaximumLineLength * 2 + 2] = {};
                 for (size_t i = 0; i < cur_size; i++) {
-                    util::SNPrintf(hex + i * 2, 3, "%02X", data_u8[data_ofs++]);
+                    const u8 cur = data_u8[data_ofs++];
+                    hex[i * 2 + 0] = HexDigits[cur >> 4];
+                    hex[i * 2 + 1] = HexDigits[cur & 0xF];
                 }
                 hex[cur_size * 2 + 0] = '\n';
                 hex[cur_size * 2 + 1] = '\x00';
@@ -89,10 +92,47 @@ namespace ams::creport {
             return;
         }
 
+        /* If we have no cache, write (and flush) immediately. */
+        if (this->cache == nullptr) {
+            this->WriteImpl(data, size, fs::WriteOption::Flush);
+            return;
+        }
+
+        /* If the data won't fit in the cache, write out what we've cached so far. */
+        if (size > this->cache_size - this->cache_offset && this->cache_offset > 0) {
+            this->WriteImpl(this->cache, this->cache_offset, fs::WriteOption::None);
+            this->cache_offset = 0;
+        }
+
+        /* Cache the data if we can, otherwise write it directly. */
+        if (size <= this->cache_size - this->cache_offset) {
+            std::memcpy(this->cache + this->cache_offset, data, size);
+            this->cache_offset += size;
+        } else {
+            this->WriteImpl(data, size, fs::WriteOption::None);
+        }
+    }
+
+    void ScopedFile::Flush() {
+        /* If we're not open, we can't flush. */
+        if (!this->IsOpen()) {
+            return;
+        }
+
+        /* Write out any cached data, flushing as we do so. */
+        if (this->cache_offset > 0) {
+            this->WriteImpl(this->cache, this->cache_offset, fs::WriteOption::Flush);
+            this->cache_offset = 0;
+        } else if (this->cache != nullptr) {
+            fs::FlushFile(this->file);
+        }
+    }
+
+    void ScopedFile::WriteImpl(const void *data, size_t size, fs::WriteOption option) {
         /* Advance, if we write successfully. */
-        if (R_SUCCEEDED(fs::WriteFile(this->file, this->offset, data, size, fs::WriteOption::Flush))) {
+        if (R_SUCCEEDED(fs::WriteFile(this->file, this->offset, data, size, option))) {
             this->offset += size;
         }
     }
 
-}
\ No newline at end of file
+}
@@ -24,9 +24,12 @@ namespace ams::creport {
         private:
             fs::FileHandle file;
             s64 offset;
+            u8 *cache;
+            size_t cache_size;
+            size_t cache_offset;
             bool opened;
         public:
-            ScopedFile(const char *path) : file(), offset(), opened(false) {
+            ScopedFile(const char *path, void *cache_buf = nullptr, size_t cache_buf_size = 0) : file(), offset(), cache(static_cast<u8 *>(cache_buf)), cache_size(cache_buf_size), cache_offset(), opened(false) {
                 if (R_SUCCEEDED(fs::CreateFile(path, 0))) {
                     this->opened = R_SUCCEEDED(fs::OpenFile(std::addressof(this->file), path, fs::OpenMode_Write | fs::OpenMode_AllowAppend));
                 }
@@ -34,6 +37,7 @@ namespace ams::creport {
 
             ~ScopedFile() {
                 if (this->opened) {
+                    this->Flush();
                     fs::CloseFile(file);
                 }
             }
@@ -47,6 +51,11 @@ namespace ams::creport {
             void DumpMemory(const char *prefix, const void *data, size_t size);
 
             void Write(const void *data, size_t size);
+
+            /* Writes out any cached data, and flushes the file. */
+            void Flush();
+        private:
+            void WriteImpl(const void *data, size_t size, fs::WriteOption option);
     };
 
 }
\ No newline at end of file
@@ -116,6 +116,10 @@ namespace ams::dmnt::cheat {
         return dmnt::cheat::impl::ResetStaticRegisters();
     }
 
+    void CheatService::GetCheatVmMemoryStatistics(sf::Out<CheatVmMemoryStatistics> out) {
+        dmnt::cheat::impl::GetCheatVmMemoryStatistics(out.GetPointer());
+    }
+
     /* ========================================================================================= */
     /* ===================================  Address Commands  ================================== */
     /* ========================================================================================= */
@@ -38,6 +38,7 @@
     AMS_SF_METHOD_INFO(C, H, 65206, Result, ReadStaticRegister,          (sf::Out<u64> out, u8 which),                                                                         (out, which))                   \
     AMS_SF_METHOD_INFO(C, H, 65207, Result, WriteStaticRegister,         (u8 which, u64 value),                                                                                (which, value))                 \
     AMS_SF_METHOD_INFO(C, H, 65208, Result, ResetStaticRegisters,        (),                                                                                                   ())                             \
+    AMS_SF_METHOD_INFO(C, H, 65209, void,   GetCheatVmMemoryStatistics,  (sf::Out<dmnt::cheat::CheatVmMemoryStatistics> out),                                                  (out))                          \
     AMS_SF_METHOD_INFO(C, H, 65300, Result, GetFrozenAddressCount,       (sf::Out<u64> out_count),                                                                             (out_count))                    \
     AMS_SF_METHOD_INFO(C, H, 65301, Result, GetFrozenAddresses,          (const sf::OutArray<dmnt::cheat::FrozenAddressEntry> &addresses, sf::Out<u64> out_count, u64 offset), (addresses, out_count, offset)) \
     AMS_SF_METHOD_INFO(C, H, 65302, Result, GetFrozenAddress,            (sf::Out<dmnt::cheat::FrozenAddressEntry> entry, u64 address),                                        (entry, address))               \
@@ -72,6 +73,7 @@ namespace ams::dmnt::cheat {
             Result ReadStaticRegister(sf::Out<u64> out, u8 which);
             Result WriteStaticRegister(u8 which, u64 value);
             Result ResetStaticRegisters();
+            void GetCheatVmMemoryStatistics(sf::Out<CheatVmMemoryStatistics> out);
 
             Result GetFrozenAddressCount(sf::Out<u64> out_count);
             Result GetFrozenAddresses(const sf::OutArray<FrozenAddressEntry> &addresses, sf::Out<u64> out_count, u64 offset);
@@ -24,7 +24,10 @@ namespace ams::dmnt::cheat::impl {
 
         /* Helper definitions. */
         constexpr size_t MaxCheatCount = 0x80;
-        constexpr size_t MaxFrozenAddressCount = 0x80;
+        constexpr size_t MaxFrozenAddressCount = 0x400;
+
+        constexpr u64 DefaultVirtualMachineTicksPerSecond = 12;
+        constexpr u64 MaxVirtualMachineTicksPerSecond     = 1000;
 
         class FrozenAddressMapEntry : public util::IntrusiveRedBlackTreeBaseNode<FrozenAddressMapEntry> {
             public:
@@ -94,6 +97,7 @@ namespace ams::dmnt::cheat::impl {
                 os::ThreadType vm_thread;
                 bool broken_unsafe = false;
                 bool needs_reload_vm = false;
+                u64 vm_tick_interval = TimeSpan::FromSeconds(1).GetNanoSeconds() / DefaultVirtualMachineTicksPerSecond;
                 CheatVirtualMachine cheat_vm;
 
                 bool enable_cheats_by_default = true;
@@ -101,6 +105,7 @@ namespace ams::dmnt::cheat::impl {
                 bool should_save_cheat_toggles = false;
                 CheatEntry cheat_entries[MaxCheatCount] = {};
                 FrozenAddressMap frozen_addresses_map = {};
+                u8 frozen_write_buffer[os::MemoryPageSize] = {};
 
                 alignas(os::MemoryPageSize) u8 detect_thread_stack[ThreadStackSize] = {};
                 alignas(os::MemoryPageSize) u8 debug_events_thread_stack[ThreadStackSize] = {};
@@ -112,6 +117,8 @@ namespace ams::dmnt::cheat::impl {
 
                 Result AttachToApplicationProcess(bool on_process_launch);
 
+                void ApplyFrozenAddresses();
+
                 bool ParseCheats(const char *s, size_t len);
                 bool LoadCheats(const ncm::ProgramId program_id, const u8 *build_id);
                 bool ParseCheatToggles(const char *s, size_t len);
@@ -264,6 +271,14 @@ namespace ams::dmnt::cheat::impl {
                         }
                     }
 
+                    /* Learn how often we should run cheats and apply frozen addresses. */
+                    {
+                        u32 ticks_per_second = 0;
+                        if (settings::fwdbg::GetSettingsItemValue(&ticks_per_second, sizeof(ticks_per_second), "atmosphere", "dmnt_cheat_vm_ticks_per_second") == sizeof(ticks_per_second) && ticks_per_second != 0) {
+                            this->vm_tick_interval = TimeSpan::FromSeconds(1).GetNanoSeconds() / std::min<u64>(ticks_per_second, MaxVirtualMachineTicksPerSecond);
+                        }
+                    }
+
                     /* Spawn application detection thread, spawn cheat vm thread. */
                     R_ABORT_UNLESS(os::CreateThread(std::addressof(this->detect_thread), DetectLaunchThread, this, this->detect_thread_stack, ThreadStackSize, AMS_GET_SYSTEM_THREAD_PRIORITY(dmnt, CheatDetect)));
                     os::SetThreadNamePointer(std::addressof(this->detect_thread), AMS_GET_SYSTEM_THREAD_NAME(dmnt, CheatDetect));
@@ -566,6 +581,12 @@ namespace ams::dmnt::cheat::impl {
                     return ResultSuccess();
                 }
 
+                void GetCheatVmMemoryStatistics(CheatVmMemoryStatistics *out) {
+                    std::scoped_lock lk(this->cheat_lock);
+
+                    *out = this->cheat_vm.GetMemoryStatistics();
+                }
+
                 Result GetFrozenAddressCount(u64 *out_count) {
                     std::scoped_lock lk(this->cheat_lock);
 
@@ -707,6 +728,46 @@ namespace ams::dmnt::cheat::impl {
             }
         }
 
+        void CheatProcessManager::ApplyFrozenAddresses() {
+            /* Frozen addresses that are contiguous within a page are written together. */
+            /* We don't merge across pages, so that an unmapped page only affects its own addresses. */
+            u64 run_address = 0;
+            size_t run_size = 0;
+
+            auto FlushRun = [&]() {
+                if (run_size > 0) {
+                    /* Use Write SVC directly, to avoid the usual frozen address update logic. */
+                    svcWriteDebugProcessMemory(this->GetCheatProcessHandle(), this->frozen_write_buffer, run_address, run_size);
+                    run_size = 0;
+                }
+            };
+
+            for (const auto &entry : this->frozen_addresses_map) {
+                const auto address = entry.GetAddress();
+                const auto &value  = entry.GetValue();
+
+                /* Check if the value continues the current run. The map is ordered, so address >= run_address. */
+                const bool continues_run = run_size > 0 && address <= run_address + run_size && address + value.width <= util::AlignDown(run_address, os::MemoryPageSize) + os::MemoryPageSize;
+                if (!continues_run) {
+                    FlushRun();
+
+                    /* Values straddling a page boundary are written on their own. */
+                    if (util::AlignDown(address, os::MemoryPageSize) != util::AlignDown(address + value.width - 1, os::MemoryPageSize)) {
+                        svcWriteDebugProcessMemory(this->GetCheatProcessHandle(), &value.value, address, value.width);
+                        continue;
+                    }
+
+                    run_address = address;
+                }
+
+                /* Add the value to the run. */
+                std::memcpy(this->frozen_write_buffer + (address - run_address), &value.value, value.width);
+                run_size = std::max<size_t>(run_size, address + value.width - run_address);
+            }
+
+            FlushRun();
+        }
+
         void CheatProcessManager::VirtualMachineThread(void *_this) {
             CheatProcessManager *this_ptr = reinterpret_cast<CheatProcessManager *>(_this);
             while (true) {
@@ -726,21 +787,12 @@ namespace ams::dmnt::cheat::impl {
                         }
 
                         /* Apply frozen addresses. */
-                        for (const auto &entry : this_ptr->frozen_addresses_map) {
-                            const auto address = entry.GetAddress();
-                            const auto &value  = entry.GetValue();
-
-                            /* Use Write SVC directly, to avoid the usual frozen address update logic. */
-                            svcWriteDebugProcessMemory(this_ptr->GetCheatProcessHandle(), &value.value, address, value.width);
-                        }
+                        this_ptr->ApplyFrozenAddresses();
                     }
                 }
 
                 /* Sleep until next potential execution. */
-                constexpr u64 ONE_SECOND = 1'000'000'000ul;
-                constexpr u64 TIMES_PER_SECOND = 12;
-                constexpr u64 DELAY_TIME = ONE_SECOND / TIMES_PER_SECOND;
-                svcSleepThread(DELAY_TIME);
+                svcSleepThread(this_ptr->vm_tick_interval);
             }
         }
 
@@ -1187,7 +1239,7 @@ namespace ams::dmnt::cheat::impl {
         return GetReference(g_cheat_process_manager).ReadCheatProcessMemoryUnsafe(process_addr, out_data, size);
     }
 
-    Result WriteCheatProcessMemoryUnsafe(u64 process_addr, void *data, size_t size) {
+    Result WriteCheatProcessMemoryUnsafe(u64 process_addr, const void *data, size_t size) {
         return GetReference(g_cheat_process_manager).WriteCheatProcessMemoryUnsafe(process_addr, data, size);
     }
 
@@ -1255,6 +1307,10 @@ namespace ams::dmnt::cheat::impl {
         return GetReference(g_cheat_process_manager).ResetStaticRegisters();
     }
 
+    void GetCheatVmMemoryStatistics(CheatVmMemoryStatistics *out) {
+        return GetReference(g_cheat_process_manager).GetCheatVmMemoryStatistics(out);
+    }
+
     Result GetFrozenAddressCount(u64 *out_count) {
         return GetReference(g_cheat_process_manager).GetFrozenAddressCount(out_count);
     }
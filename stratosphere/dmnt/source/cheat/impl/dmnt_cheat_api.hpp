@@ -28,7 +28,7 @@ namespace ams::dmnt::cheat::impl {
     Result ResumeCheatProcess();
 
     Result ReadCheatProcessMemoryUnsafe(u64 process_addr, void *out_data, size_t size);
-    Result WriteCheatProcessMemoryUnsafe(u64 process_addr, void *data, size_t size);
+    Result WriteCheatProcessMemoryUnsafe(u64 process_addr, const void *data, size_t size);
 
     Result PauseCheatProcessUnsafe();
     Result ResumeCheatProcessUnsafe();
@@ -48,6 +48,7 @@ namespace ams::dmnt::cheat::impl {
     Result ReadStaticRegister(u64 *out, size_t which);
     Result WriteStaticRegister(size_t which, u64 value);
     Result ResetStaticRegisters();
+    void GetCheatVmMemoryStatistics(CheatVmMemoryStatistics *out);
 
     Result GetFrozenAddressCount(u64 *out_count);
     Result GetFrozenAddresses(FrozenAddressEntry *frz_addrs, size_t max_count, u64 *out_count, u64 offset);
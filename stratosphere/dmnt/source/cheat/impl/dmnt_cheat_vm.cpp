@@ -667,26 +667,50 @@ namespace ams::dmnt::cheat::impl {
         return valid;
     }
 
-    void CheatVirtualMachine::SkipConditionalBlock() {
-        if (this->condition_depth > 0) {
-            /* We want to continue until we're out of the current block. */
-            const size_t desired_depth = this->condition_depth - 1;
-
-            CheatVmOpcode skip_opcode;
-            while (this->condition_depth > desired_depth && this->DecodeNextOpcode(&skip_opcode)) {
-                /* Decode instructions until we see end of the current conditional block. */
-                /* NOTE: This is broken in gateway's implementation. */
-                /* Gateway currently checks for "0x2" instead of "0x20000000" */
-                /* In addition, they do a linear scan instead of correctly decoding opcodes. */
-                /* This causes issues if "0x2" appears as an immediate in the conditional block... */
+    void CheatVirtualMachine::CompileProgram() {
+        /* Decode the program once, so that execution doesn't have to re-decode it every frame. */
+        /* NOTE: Decoding stops at the first invalid opcode, which is where execution would have stopped. */
+        this->num_instructions = 0;
+        this->instruction_ptr = 0;
+        this->decode_success = true;
+        while (this->DecodeNextOpcode(std::addressof(this->instructions[this->num_instructions]))) {
+            this->num_instructions++;
+        }
 
-                /* We also support nesting of conditional blocks, and Gateway does not. */
-                if (skip_opcode.begin_conditional_block) {
-                    this->condition_depth++;
-                } else if (skip_opcode.opcode == CheatVmOpcodeType_EndConditionalBlock) {
-                    this->condition_depth--;
-                }
+        /* Resolve the end of every conditional block. */
+        /* While a block is open, its entry holds the index of the enclosing open block. */
+        constexpr size_t NoOpenBlock = MaximumProgramOpcodeCount;
+        size_t open_block = NoOpenBlock;
+        for (size_t i = 0; i < this->num_instructions; i++) {
+            if (this->instructions[i].begin_conditional_block) {
+                this->block_ends[i] = static_cast<u16>(open_block);
+                open_block = i;
+            } else if (this->instructions[i].opcode == CheatVmOpcodeType_EndConditionalBlock && open_block != NoOpenBlock) {
+                const size_t parent_block = this->block_ends[open_block];
+                this->block_ends[open_block] = static_cast<u16>(i + 1);
+                open_block = parent_block;
             }
+        }
+
+        /* Blocks that are never closed extend to the end of the program. */
+        while (open_block != NoOpenBlock) {
+            const size_t parent_block = this->block_ends[open_block];
+            this->block_ends[open_block] = static_cast<u16>(this->num_instructions);
+            open_block = parent_block;
+        }
+    }
+
+    void CheatVirtualMachine::SkipConditionalBlock(size_t begin_index) {
+        if (this->condition_depth > 0) {
+            /* Continue after the end of the current conditional block, which was found when the program was compiled. */
+            /* NOTE: This is broken in gateway's implementation. */
+            /* Gateway currently checks for "0x2" instead of "0x20000000" */
+            /* In addition, they do a linear scan instead of correctly decoding opcodes. */
+            /* This causes issues if "0x2" appears as an immediate in the conditional block... */
+
+            /* We also support nesting of conditional blocks, and Gateway does not. */
+            this->instruction_ptr = this->block_ends[begin_index];
+            this->condition_depth--;
         } else {
             /* Skipping, but this->condition_depth = 0. */
             /* This is an error condition. */
@@ -743,6 +767,7 @@ namespace ams::dmnt::cheat::impl {
                 /* Bounds check. */
                 if (cheats[i].definition.num_opcodes + this->num_opcodes > MaximumProgramOpcodeCount) {
                     this->num_opcodes = 0;
+                    this->num_instructions = 0;
                     return false;
                 }
 
@@ -752,11 +777,13 @@ namespace ams::dmnt::cheat::impl {
             }
         }
 
+        /* Decode the loaded program. */
+        this->CompileProgram();
+
         return true;
     }
 
     void CheatVirtualMachine::Execute(const CheatProcessMetadata *metadata) {
-        CheatVmOpcode cur_opcode;
         u64 kHeld = 0;
 
         /* Get Keys held. */
@@ -773,8 +800,14 @@ namespace ams::dmnt::cheat::impl {
         /* Clear VM state. */
         this->ResetState();
 
+        /* Write back any buffered memory accesses once we're done. */
+        ON_SCOPE_EXIT { this->memory_cache.Flush(); };
+
         /* Loop until program finishes. */
-        while (this->DecodeNextOpcode(&cur_opcode)) {
+        while (this->instruction_ptr < this->num_instructions) {
+            const size_t cur_index = this->instruction_ptr++;
+            const CheatVmOpcode &cur_opcode = this->instructions[cur_index];
+
             this->LogToDebugFile("Instruction Ptr: %04x\n", (u32)this->instruction_ptr);
 
             for (size_t i = 0; i < NumRegisters; i++) {
@@ -802,7 +835,7 @@ namespace ams::dmnt::cheat::impl {
                             case 2:
                             case 4:
                             case 8:
-                                dmnt::cheat::impl::WriteCheatProcessMemoryUnsafe(dst_address, &dst_value, cur_opcode.store_static.bit_width);
+                                this->memory_cache.Write(dst_address, &dst_value, cur_opcode.store_static.bit_width);
                                 break;
                         }
                     }
@@ -817,7 +850,7 @@ namespace ams::dmnt::cheat::impl {
                             case 2:
                             case 4:
                             case 8:
-                                dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(src_address, &src_value, cur_opcode.begin_cond.bit_width);
+                                this->memory_cache.Read(src_address, &src_value, cur_opcode.begin_cond.bit_width);
                                 break;
                         }
                         /* Check against condition. */
@@ -845,7 +878,7 @@ namespace ams::dmnt::cheat::impl {
                         }
                         /* Skip conditional block if condition not met. */
                         if (!cond_met) {
-                            this->SkipConditionalBlock();
+                            this->SkipConditionalBlock(cur_index);
                         }
                     }
                     break;
@@ -888,7 +921,7 @@ namespace ams::dmnt::cheat::impl {
                             case 2:
                             case 4:
                             case 8:
-                                dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(src_address, &this->registers[cur_opcode.ldr_memory.reg_index], cur_opcode.ldr_memory.bit_width);
+                                this->memory_cache.Read(src_address, &this->registers[cur_opcode.ldr_memory.reg_index], cur_opcode.ldr_memory.bit_width);
                                 break;
                         }
                     }
@@ -907,7 +940,7 @@ namespace ams::dmnt::cheat::impl {
                             case 2:
                             case 4:
                             case 8:
-                                dmnt::cheat::impl::WriteCheatProcessMemoryUnsafe(dst_address, &dst_value, cur_opcode.str_static.bit_width);
+                                this->memory_cache.Write(dst_address, &dst_value, cur_opcode.str_static.bit_width);
                                 break;
                         }
                         /* Increment register if relevant. */
@@ -960,7 +993,7 @@ namespace ams::dmnt::cheat::impl {
                     /* Check for keypress. */
                     if ((cur_opcode.begin_keypress_cond.key_mask & kHeld) != cur_opcode.begin_keypress_cond.key_mask) {
                         /* Keys not pressed. Skip conditional block. */
-                        this->SkipConditionalBlock();
+                        this->SkipConditionalBlock(cur_index);
                     }
                     break;
                 case CheatVmOpcodeType_PerformArithmeticRegister:
@@ -1058,7 +1091,7 @@ namespace ams::dmnt::cheat::impl {
                             case 2:
                             case 4:
                             case 8:
-                                dmnt::cheat::impl::WriteCheatProcessMemoryUnsafe(dst_address, &dst_value, cur_opcode.str_register.bit_width);
+                                this->memory_cache.Write(dst_address, &dst_value, cur_opcode.str_register.bit_width);
                                 break;
                         }
 
@@ -1129,7 +1162,7 @@ namespace ams::dmnt::cheat::impl {
                                 case 2:
                                 case 4:
                                 case 8:
-                                    dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(cond_address, &cond_value, cur_opcode.begin_reg_cond.bit_width);
+                                    this->memory_cache.Read(cond_address, &cond_value, cur_opcode.begin_reg_cond.bit_width);
                                     break;
                             }
                         }
@@ -1159,7 +1192,7 @@ namespace ams::dmnt::cheat::impl {
 
                         /* Skip conditional block if condition not met. */
                         if (!cond_met) {
-                            this->SkipConditionalBlock();
+                            this->SkipConditionalBlock(cur_index);
                         }
                     }
                     break;
@@ -1224,9 +1257,13 @@ namespace ams::dmnt::cheat::impl {
                     }
                     break;
                 case CheatVmOpcodeType_PauseProcess:
+                    /* Memory may change while we're running, so don't keep anything we read beforehand. */
+                    this->memory_cache.Flush();
                     dmnt::cheat::impl::PauseCheatProcessUnsafe();
                     break;
                 case CheatVmOpcodeType_ResumeProcess:
+                    /* Make sure everything written while paused lands before the process runs again. */
+                    this->memory_cache.Flush();
                     dmnt::cheat::impl::ResumeCheatProcessUnsafe();
                     break;
                 case CheatVmOpcodeType_DebugLog:
@@ -1271,7 +1308,7 @@ namespace ams::dmnt::cheat::impl {
                                 case 2:
                                 case 4:
                                 case 8:
-                                    dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(val_address, &log_value, cur_opcode.debug_log.bit_width);
+                                    this->memory_cache.Read(val_address, &log_value, cur_opcode.debug_log.bit_width);
                                     break;
                             }
                         }
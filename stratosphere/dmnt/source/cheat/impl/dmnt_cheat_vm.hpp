@@ -15,6 +15,7 @@
  */
 #pragma once
 #include <stratosphere.hpp>
+#include "dmnt_cheat_vm_memory_cache.hpp"
 
 namespace ams::dmnt::cheat::impl {
 
@@ -274,17 +275,22 @@ namespace ams::dmnt::cheat::impl {
             constexpr static size_t NumStaticRegisters = NumReadableStaticRegisters + NumWritableStaticRegisters;
         private:
             size_t num_opcodes = 0;
+            size_t num_instructions = 0;
             size_t instruction_ptr = 0;
             size_t condition_depth = 0;
             bool decode_success = false;
             u32 program[MaximumProgramOpcodeCount] = {0};
+            CheatVmOpcode instructions[MaximumProgramOpcodeCount] = {};
+            u16 block_ends[MaximumProgramOpcodeCount] = {0};
             u64 registers[NumRegisters] = {0};
             u64 saved_values[NumRegisters] = {0};
             u64 static_registers[NumStaticRegisters] = {0};
             size_t loop_tops[NumRegisters] = {0};
+            CheatVmMemoryCache memory_cache;
         private:
             bool DecodeNextOpcode(CheatVmOpcode *out);
-            void SkipConditionalBlock();
+            void CompileProgram();
+            void SkipConditionalBlock(size_t begin_index);
             void ResetState();
 
             /* For implementing the DebugLog opcode. */
@@ -319,6 +325,10 @@ namespace ams::dmnt::cheat::impl {
             void ResetStaticRegisters() {
                 std::memset(this->static_registers, 0, sizeof(this->static_registers));
             }
+
+            const CheatVmMemoryStatistics &GetMemoryStatistics() const {
+                return this->memory_cache.GetStatistics();
+            }
     #ifdef DMNT_CHEAT_VM_DEBUG_LOG
         private:
             fs::FileHandle debug_log_file;
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "dmnt_cheat_api.hpp"
+#include "dmnt_cheat_vm_memory_cache.hpp"
+
+namespace ams::dmnt::cheat::impl {
+
+    CheatVmMemoryCache::Page *CheatVmMemoryCache::GetPage(u64 page_address) {
+        /* Check if we already have the page. */
+        for (size_t i = 0; i < this->num_pages; i++) {
+            if (Page *page = std::addressof(this->pages[i]); page->address == page_address) {
+                page->num_accesses++;
+                page->last_access = ++this->access_counter;
+                return page;
+            }
+        }
+
+        /* Pick a page to use, writing back and discarding the least recently used page if we're out. */
+        Page *page;
+        if (this->num_pages < MaxCachedPages) {
+            page = std::addressof(this->pages[this->num_pages++]);
+        } else {
+            page = std::addressof(this->pages[0]);
+            for (size_t i = 1; i < this->num_pages; i++) {
+                if (this->pages[i].last_access < page->last_access) {
+                    page = std::addressof(this->pages[i]);
+                }
+            }
+            this->FlushPage(page);
+        }
+
+        /* Set up the new page. */
+        page->address       = page_address;
+        page->is_loaded     = false;
+        page->is_unreadable = this->IsUnreadable(page_address);
+        page->is_dirty      = false;
+        page->num_accesses  = 1;
+        page->last_access   = ++this->access_counter;
+        std::memset(page->dirty_mask, 0, sizeof(page->dirty_mask));
+        return page;
+    }
+
+    void CheatVmMemoryCache::ReadFromPage(Page *page, size_t offset, void *out, size_t size) {
+        /* Load the page once it's been accessed repeatedly, if we haven't yet, and haven't already failed to. */
+        /* Until then, it's cheaper to read just what was asked for. */
+        if (!page->is_loaded && !page->is_unreadable && page->num_accesses >= LoadAccessCount) {
+            this->statistics.num_read_svcs++;
+            if (R_SUCCEEDED(dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(page->address, this->work_buffer, PageSize))) {
+                /* Don't overwrite anything we've written but not yet flushed. */
+                if (page->is_dirty) {
+                    for (size_t i = 0; i < PageSize; i++) {
+                        if (!IsDirty(page, i)) {
+                            page->data[i] = this->work_buffer[i];
+                        }
+                    }
+                } else {
+                    std::memcpy(page->data, this->work_buffer, PageSize);
+                }
+                page->is_loaded = true;
+            } else {
+                /* Don't retry the whole page on every access. */
+                this->SetUnreadable(page);
+            }
+        }
+
+        if (page->is_loaded) {
+            std::memcpy(out, page->data + offset, size);
+        } else {
+            /* We haven't read the whole page, so read just what was asked for. */
+            this->statistics.num_read_svcs++;
+            dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(page->address + offset, out, size);
+
+            /* Apply any writes that haven't been flushed yet. */
+            u8 *dst = static_cast<u8 *>(out);
+            for (size_t i = 0; i < size; i++) {
+                if (IsDirty(page, offset + i)) {
+                    dst[i] = page->data[offset + i];
+                }
+            }
+        }
+    }
+
+    void CheatVmMemoryCache::WriteToPage(Page *page, size_t offset, const void *data, size_t size) {
+        std::memcpy(page->data + offset, data, size);
+        for (size_t i = offset; i < offset + size; i++) {
+            page->dirty_mask[i / BITSIZEOF(u64)] |= (UINT64_C(1) << (i % BITSIZEOF(u64)));
+        }
+        page->is_dirty = true;
+    }
+
+    void CheatVmMemoryCache::FlushPage(Page *page) {
+        if (!page->is_dirty) {
+            return;
+        }
+
+        /* Write each contiguous run of dirty bytes at once. */
+        size_t offset = 0;
+        while (offset < PageSize) {
+            /* Skip clean bytes. */
+            if ((offset % BITSIZEOF(u64)) == 0 && page->dirty_mask[offset / BITSIZEOF(u64)] == 0) {
+                offset += BITSIZEOF(u64);
+                continue;
+            }
+            if (!IsDirty(page, offset)) {
+                offset++;
+                continue;
+            }
+
+            /* Find the end of the run. */
+            size_t end = offset + 1;
+            while (end < PageSize && IsDirty(page, end)) {
+                end++;
+            }
+
+            this->statistics.num_write_svcs++;
+            dmnt::cheat::impl::WriteCheatProcessMemoryUnsafe(page->address + offset, page->data + offset, end - offset);
+
+            offset = end;
+        }
+
+        std::memset(page->dirty_mask, 0, sizeof(page->dirty_mask));
+        page->is_dirty = false;
+    }
+
+    void CheatVmMemoryCache::FlushPages() {
+        for (size_t i = 0; i < this->num_pages; i++) {
+            this->FlushPage(std::addressof(this->pages[i]));
+        }
+        this->num_pages = 0;
+    }
+
+    bool CheatVmMemoryCache::IsUnreadable(u64 page_address) const {
+        for (size_t i = 0; i < this->num_unreadable_pages; i++) {
+            if (this->unreadable_pages[i] == page_address) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void CheatVmMemoryCache::SetUnreadable(Page *page) {
+        page->is_unreadable = true;
+
+        /* Remember the page even once it's been discarded, if we have room. */
+        if (this->num_unreadable_pages < MaxUnreadablePages) {
+            this->unreadable_pages[this->num_unreadable_pages++] = page->address;
+        }
+    }
+
+    void CheatVmMemoryCache::Read(u64 address, void *out, size_t size) {
+        this->statistics.num_reads++;
+
+        u8 *dst = static_cast<u8 *>(out);
+        while (size > 0) {
+            const u64 page_address = util::AlignDown(address, PageSize);
+            const size_t offset    = address - page_address;
+            const size_t cur_size  = std::min(size, PageSize - offset);
+
+            this->ReadFromPage(this->GetPage(page_address), offset, dst, cur_size);
+
+            address += cur_size;
+            dst     += cur_size;
+            size    -= cur_size;
+        }
+    }
+
+    void CheatVmMemoryCache::Write(u64 address, const void *data, size_t size) {
+        this->statistics.num_writes++;
+
+        const u8 *src = static_cast<const u8 *>(data);
+        while (size > 0) {
+            const u64 page_address = util::AlignDown(address, PageSize);
+            const size_t offset    = address - page_address;
+            const size_t cur_size  = std::min(size, PageSize - offset);
+
+            this->WriteToPage(this->GetPage(page_address), offset, src, cur_size);
+
+            address += cur_size;
+            src     += cur_size;
+            size    -= cur_size;
+        }
+    }
+
+    void CheatVmMemoryCache::Flush() {
+        this->FlushPages();
+
+        /* Memory may be mapped by the time we're next used, so forget which pages couldn't be read. */
+        this->num_unreadable_pages = 0;
+    }
+
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::dmnt::cheat::impl {
+
+    /* Batches the cheat process memory accesses made during a single VM execution. */
+    /* Pages are only loaded whole once they're accessed repeatedly, writes are buffered and flushed as contiguous runs per page. */
+    class CheatVmMemoryCache {
+        NON_COPYABLE(CheatVmMemoryCache);
+        NON_MOVEABLE(CheatVmMemoryCache);
+        public:
+            static constexpr size_t PageSize = 0x1000;
+            static constexpr size_t MaxCachedPages = 8;
+            static constexpr size_t MaxUnreadablePages = 8;
+            static constexpr size_t LoadAccessCount = 2;
+        private:
+            static constexpr size_t DirtyWordCount = PageSize / BITSIZEOF(u64);
+
+            struct Page {
+                u64 address;
+                bool is_loaded;
+                bool is_unreadable;
+                bool is_dirty;
+                size_t num_accesses;
+                u64 last_access;
+                u8 data[PageSize];
+                u64 dirty_mask[DirtyWordCount];
+            };
+        private:
+            Page pages[MaxCachedPages];
+            size_t num_pages;
+            u64 access_counter;
+            u64 unreadable_pages[MaxUnreadablePages];
+            size_t num_unreadable_pages;
+            u8 work_buffer[PageSize];
+            CheatVmMemoryStatistics statistics;
+        private:
+            Page *GetPage(u64 page_address);
+            void ReadFromPage(Page *page, size_t offset, void *out, size_t size);
+            void WriteToPage(Page *page, size_t offset, const void *data, size_t size);
+            void FlushPage(Page *page);
+            void FlushPages();
+
+            bool IsUnreadable(u64 page_address) const;
+            void SetUnreadable(Page *page);
+
+            static bool IsDirty(const Page *page, size_t offset) {
+                return (page->dirty_mask[offset / BITSIZEOF(u64)] & (UINT64_C(1) << (offset % BITSIZEOF(u64)))) != 0;
+            }
+        public:
+            CheatVmMemoryCache() : num_pages(0), access_counter(0), num_unreadable_pages(0), statistics() { /* ... */ }
+
+            void Read(u64 address, void *out, size_t size);
+            void Write(u64 address, const void *data, size_t size);
+
+            /* Writes back all buffered data, and discards everything cached, including which pages couldn't be read. */
+            void Flush();
+
+            const CheatVmMemoryStatistics &GetStatistics() const {
+                return this->statistics;
+            }
+    };
+
+}
@@ -21,10 +21,6 @@ namespace ams::fatal::srv::font {
 
     constinit lmem::HeapHandle g_font_heap_handle;
 
-    void SetHeapMemory(void *memory, size_t memory_size) {
-        g_font_heap_handle = lmem::CreateExpHeap(memory, memory_size, lmem::CreateOption_None);
-    }
-
     void *AllocateForFont(size_t size) {
         return lmem::AllocateFromExpHeap(g_font_heap_handle, size);
     }
@@ -65,6 +61,9 @@ namespace ams::fatal::srv::font {
         /* Font state globals. */
         u16 *g_frame_buffer = nullptr;
         u32 (*g_unswizzle_func)(u32, u32) = nullptr;
+        u32 g_frame_buffer_width = 0, g_frame_buffer_height = 0;
+        u32 *g_column_offsets = nullptr;
+        u32 *g_row_offsets = nullptr;
         u16 g_font_color = 0xFFFF; /* White. */
         float g_font_line_pixels = 16.0f;
         float g_font_size = 16.0f;
@@ -76,6 +75,26 @@ namespace ams::fatal::srv::font {
 
         stbtt_fontinfo g_stb_font;
 
+        /* Glyph cache. */
+        constexpr size_t GlyphCacheEntryCount = 0x100;
+        static_assert(util::IsPowerOfTwo(GlyphCacheEntryCount));
+
+        struct GlyphCacheEntry {
+            u32 codepoint;
+            float scale;
+            int glyph_index;
+            int adv_width;
+            int width;
+            int height;
+            int x0;
+            int y0;
+            u8 *bitmap;
+            bool in_use;
+        };
+
+        GlyphCacheEntry g_glyph_cache[GlyphCacheEntryCount];
+        size_t g_glyph_cache_count;
+
         /* Helpers. */
         u16 Blend(u16 color, u16 bg, u8 alpha) {
             const u32 c_r = RGB565_GET_R8(color);
@@ -92,16 +111,98 @@ namespace ams::fatal::srv::font {
             return RGB888_TO_RGB565(r, g, b);
         }
 
-        void DrawCodePoint(u32 codepoint, u32 x, u32 y) {
-            int width = 0, height = 0;
-            u8* imageptr = stbtt_GetCodepointBitmap(&g_stb_font, g_font_size, g_font_size, codepoint, &width, &height, 0, 0);
-            ON_SCOPE_EXIT { DeallocateForFont(imageptr); };
+        void ClearGlyphCache() {
+            for (auto &entry : g_glyph_cache) {
+                if (entry.in_use) {
+                    DeallocateForFont(entry.bitmap);
+                }
+                entry = {};
+            }
+            g_glyph_cache_count = 0;
+        }
+
+        void InvalidateHeapAllocations() {
+            /* Anything we allocated from a previous heap is gone. */
+            for (auto &entry : g_glyph_cache) {
+                entry = {};
+            }
+            g_glyph_cache_count = 0;
+
+            g_column_offsets      = nullptr;
+            g_row_offsets         = nullptr;
+            g_frame_buffer_width  = 0;
+            g_frame_buffer_height = 0;
+        }
+
+        size_t GetGlyphCacheIndex(u32 codepoint, float scale) {
+            u32 scale_bits;
+            std::memcpy(std::addressof(scale_bits), std::addressof(scale), sizeof(scale_bits));
+            return ((codepoint * 0x9E3779B1u) ^ scale_bits) & (GlyphCacheEntryCount - 1);
+        }
+
+        const GlyphCacheEntry *GetGlyph(u32 codepoint) {
+            /* Find the glyph at the current size, or a free entry to put it in. */
+            size_t index = GetGlyphCacheIndex(codepoint, g_font_size);
+            while (g_glyph_cache[index].in_use) {
+                if (g_glyph_cache[index].codepoint == codepoint && g_glyph_cache[index].scale == g_font_size) {
+                    return std::addressof(g_glyph_cache[index]);
+                }
+                index = (index + 1) & (GlyphCacheEntryCount - 1);
+            }
+
+            /* Keep the cache at most half full, so that lookups stay short. */
+            if (g_glyph_cache_count >= GlyphCacheEntryCount / 2) {
+                ClearGlyphCache();
+                index = GetGlyphCacheIndex(codepoint, g_font_size);
+            }
+
+            /* Rasterize the glyph, and remember its metrics. */
+            GlyphCacheEntry *entry = std::addressof(g_glyph_cache[index]);
+            entry->codepoint   = codepoint;
+            entry->scale       = g_font_size;
+            entry->glyph_index = stbtt_FindGlyphIndex(&g_stb_font, codepoint);
+
+            int left_side_bearing;
+            stbtt_GetGlyphHMetrics(&g_stb_font, entry->glyph_index, &entry->adv_width, &left_side_bearing);
+
+            entry->bitmap = stbtt_GetGlyphBitmap(&g_stb_font, g_font_size, g_font_size, entry->glyph_index, &entry->width, &entry->height, &entry->x0, &entry->y0);
+            if (entry->bitmap == nullptr) {
+                entry->width  = 0;
+                entry->height = 0;
+            }
+
+            entry->in_use = true;
+            g_glyph_cache_count++;
+            return entry;
+        }
 
-            for (int tmpy = 0; tmpy < height; tmpy++) {
-                for (int tmpx = 0; tmpx < width; tmpx++) {
-                    /* Implement very simple blending, as the bitmap value is an alpha value. */
-                    u16 *ptr = &g_frame_buffer[g_unswizzle_func(x + tmpx, y + tmpy)];
-                    *ptr = Blend(g_font_color, *ptr, imageptr[width * tmpy + tmpx]);
+        void DrawGlyph(const GlyphCacheEntry *glyph, u32 x, u32 y) {
+            const u32 width  = static_cast<u32>(glyph->width);
+            const u32 height = static_cast<u32>(glyph->height);
+            const u8 *imageptr = glyph->bitmap;
+
+            /* Implement very simple blending, as the bitmap value is an alpha value. */
+            if (g_column_offsets != nullptr && g_row_offsets != nullptr && x + width <= g_frame_buffer_width && y + height <= g_frame_buffer_height) {
+                /* The block linear layout is separable, so use our precomputed per-row and per-column offsets. */
+                for (u32 tmpy = 0; tmpy < height; tmpy++) {
+                    u16 *row = g_frame_buffer + g_row_offsets[y + tmpy];
+                    const u32 *column_offsets = g_column_offsets + x;
+                    for (u32 tmpx = 0; tmpx < width; tmpx++) {
+                        const u8 alpha = imageptr[width * tmpy + tmpx];
+                        if (alpha == 0) {
+                            continue;
+                        }
+
+                        u16 *ptr = row + column_offsets[tmpx];
+                        *ptr = (alpha == 0xFF) ? g_font_color : Blend(g_font_color, *ptr, alpha);
+                    }
+                }
+            } else {
+                for (u32 tmpy = 0; tmpy < height; tmpy++) {
+                    for (u32 tmpx = 0; tmpx < width; tmpx++) {
+                        u16 *ptr = &g_frame_buffer[g_unswizzle_func(x + tmpx, y + tmpy)];
+                        *ptr = Blend(g_font_color, *ptr, imageptr[width * tmpy + tmpx]);
+                    }
                 }
             }
         }
@@ -111,36 +212,35 @@ namespace ams::fatal::srv::font {
 
             u32 cur_x = g_cur_x, cur_y = g_cur_y;
 
-            u32 prev_char = 0;
+            int prev_glyph_index = 0;
             for (u32 i = 0; i < len; ) {
                 u32 cur_char;
                 ssize_t unit_count = decode_utf8(&cur_char, reinterpret_cast<const u8 *>(&str[i]));
                 if (unit_count <= 0) break;
 
-                if (!g_mono_adv && i > 0) {
-                    cur_x += g_font_size * stbtt_GetCodepointKernAdvance(&g_stb_font, prev_char, cur_char);
-                }
-
-                i += unit_count;
-
                 if (cur_char == '\n') {
+                    i += unit_count;
+
                     cur_x = g_line_x;
                     cur_y += g_font_line_pixels;
                     continue;
                 }
 
-                int adv_width, left_side_bearing;
-                stbtt_GetCodepointHMetrics(&g_stb_font, cur_char, &adv_width, &left_side_bearing);
-                const u32 cur_width = static_cast<u32>(adv_width) * g_font_size;
+                const GlyphCacheEntry *glyph = GetGlyph(cur_char);
 
-                int x0, y0, x1, y1;
-                stbtt_GetCodepointBitmapBoxSubpixel(&g_stb_font, cur_char, g_font_size, g_font_size, 0, 0, &x0, &y0, &x1, &y1);
+                if (!g_mono_adv && i > 0) {
+                    cur_x += g_font_size * stbtt_GetGlyphKernAdvance(&g_stb_font, prev_glyph_index, glyph->glyph_index);
+                }
 
-                DrawCodePoint(cur_char, cur_x + x0 + ((mono && g_mono_adv > cur_width) ? ((g_mono_adv - cur_width) / 2) : 0), cur_y + y0);
+                i += unit_count;
+
+                const u32 cur_width = static_cast<u32>(glyph->adv_width) * g_font_size;
+
+                DrawGlyph(glyph, cur_x + glyph->x0 + ((mono && g_mono_adv > cur_width) ? ((g_mono_adv - cur_width) / 2) : 0), cur_y + glyph->y0);
 
                 cur_x += (mono ? g_mono_adv : cur_width);
 
-                prev_char = cur_char;
+                prev_glyph_index = glyph->glyph_index;
             }
 
             if (add_line) {
@@ -242,9 +342,33 @@ namespace ams::fatal::srv::font {
         g_cur_y += static_cast<u32>(g_font_line_pixels * num_lines);
     }
 
-    void ConfigureFontFramebuffer(u16 *fb, u32 (*unswizzle_func)(u32, u32)) {
+    void SetHeapMemory(void *memory, size_t memory_size) {
+        g_font_heap_handle = lmem::CreateExpHeap(memory, memory_size, lmem::CreateOption_None);
+        InvalidateHeapAllocations();
+    }
+
+    void ConfigureFontFramebuffer(u16 *fb, u32 width, u32 height, u32 (*unswizzle_func)(u32, u32)) {
         g_frame_buffer = fb;
         g_unswizzle_func = unswizzle_func;
+
+        /* Precompute the offsets of each column and row, so that drawing doesn't need to unswizzle every pixel. */
+        DeallocateForFont(g_column_offsets);
+        DeallocateForFont(g_row_offsets);
+        g_column_offsets = static_cast<u32 *>(AllocateForFont(sizeof(u32) * width));
+        g_row_offsets    = static_cast<u32 *>(AllocateForFont(sizeof(u32) * height));
+        if (g_column_offsets != nullptr && g_row_offsets != nullptr) {
+            for (u32 x = 0; x < width; x++) {
+                g_column_offsets[x] = unswizzle_func(x, 0);
+            }
+            for (u32 y = 0; y < height; y++) {
+                g_row_offsets[y] = unswizzle_func(0, y);
+            }
+            g_frame_buffer_width  = width;
+            g_frame_buffer_height = height;
+        } else {
+            g_frame_buffer_width  = 0;
+            g_frame_buffer_height = 0;
+        }
     }
 
     Result InitializeSharedFont() {
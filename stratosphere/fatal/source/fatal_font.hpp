@@ -19,7 +19,7 @@
 namespace ams::fatal::srv::font {
 
     Result InitializeSharedFont();
-    void ConfigureFontFramebuffer(u16 *fb, u32 (*unswizzle_func)(u32, u32));
+    void ConfigureFontFramebuffer(u16 *fb, u32 width, u32 height, u32 (*unswizzle_func)(u32, u32));
     void SetHeapMemory(void *memory, size_t memory_size);
 
     void SetFontColor(u16 color);
@@ -210,7 +210,7 @@ namespace ams::fatal::srv {
             ON_SCOPE_EXIT { std::memset(g_nv_transfer_memory, 0, sizeof(g_nv_transfer_memory)); };
 
             /* Let the font manager know about our framebuffer. */
-            font::ConfigureFontFramebuffer(tiled_buf, GetPixelOffset);
+            font::ConfigureFontFramebuffer(tiled_buf, FatalScreenWidth, FatalScreenHeight, GetPixelOffset);
             font::SetFontColor(0xFFFF);
 
             /* Draw a background. */
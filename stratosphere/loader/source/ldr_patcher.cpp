@@ -54,6 +54,11 @@ namespace ams::ldr {
 
     }
 
+    /* Check for changed IPS patches before the next module is patched. */
+    void RequestIpsPatchRevalidation() {
+        ams::patcher::RequestPatchIndexRevalidation();
+    }
+
     /* Apply IPS patches. */
     void LocateAndApplyIpsPatchesToModule(const u8 *build_id, uintptr_t mapped_nso, size_t mapped_size) {
         if (!EnsureSdCardMounted()) {
@@ -18,6 +18,9 @@
 
 namespace ams::ldr {
 
+    /* Check for changed IPS patches before the next module is patched. */
+    void RequestIpsPatchRevalidation();
+
     /* Apply IPS patches. */
     void LocateAndApplyIpsPatchesToModule(const u8 *build_id, uintptr_t mapped_nso, size_t mapped_size);
 
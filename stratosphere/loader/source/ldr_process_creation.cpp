@@ -21,6 +21,7 @@
 #include "ldr_patcher.hpp"
 #include "ldr_process_creation.hpp"
 #include "ldr_ro_manager.hpp"
+#include "ldr_segment_decompressor.hpp"
 
 namespace ams::ldr {
 
@@ -28,6 +29,7 @@ namespace ams::ldr {
 
         /* Convenience defines. */
         constexpr size_t SystemResourceSizeMax = 0x1FE00000;
+        constexpr size_t NsoSegmentChunkSize   = 256_KB;
 
         /* Types. */
         enum NsoIndex {
@@ -488,22 +490,50 @@ namespace ams::ldr {
             R_UNLESS(file_size <= segment->size,                       ResultInvalidNso());
             R_UNLESS(segment->size <= std::numeric_limits<s32>::max(), ResultInvalidNso());
 
-            /* Load data from file. */
-            uintptr_t load_address = is_compressed ? map_end - file_size : map_base;
-            size_t read_size;
-            R_TRY(fs::ReadFile(std::addressof(read_size), file, segment->file_offset, reinterpret_cast<void *>(load_address), file_size));
-            R_UNLESS(read_size == file_size, ResultInvalidNso());
+            /* Determine where to load data from file. */
+            const uintptr_t load_address = is_compressed ? map_end - file_size : map_base;
 
-            /* Uncompress if necessary. */
+            /* Prepare to check the hash, if necessary. */
+            crypto::Sha256Generator sha;
+            if (check_hash) {
+                sha.Initialize();
+            }
+
+            /* Read the segment a chunk at a time, decompressing and hashing what we can as each chunk arrives, while it's still in cache. */
+            SegmentDecompressor decompressor(reinterpret_cast<void *>(map_base), segment->size, reinterpret_cast<const void *>(load_address), file_size);
+            size_t loaded_size = 0;
+            size_t hashed_size = 0;
+            while (loaded_size < file_size) {
+                /* Read the next chunk. */
+                const size_t cur_size = std::min(NsoSegmentChunkSize, file_size - loaded_size);
+                size_t read_size;
+                R_TRY(fs::ReadFile(std::addressof(read_size), file, segment->file_offset + loaded_size, reinterpret_cast<void *>(load_address + loaded_size), cur_size));
+                R_UNLESS(read_size == cur_size, ResultInvalidNso());
+                loaded_size += cur_size;
+
+                /* Uncompress if necessary. */
+                size_t available_size = loaded_size;
+                if (is_compressed) {
+                    R_TRY(decompressor.Decompress(reinterpret_cast<const void *>(load_address + loaded_size)));
+                    available_size = decompressor.GetDecompressedSize();
+                }
+
+                /* Hash the newly available data, if necessary. */
+                if (check_hash) {
+                    sha.Update(reinterpret_cast<const void *>(map_base + hashed_size), available_size - hashed_size);
+                    hashed_size = available_size;
+                }
+            }
+
+            /* Check that we uncompressed the whole segment, if necessary. */
             if (is_compressed) {
-                bool decompressed = (util::DecompressLZ4(reinterpret_cast<void *>(map_base), segment->size, reinterpret_cast<const void *>(load_address), file_size) == static_cast<int>(segment->size));
-                R_UNLESS(decompressed, ResultInvalidNso());
+                R_UNLESS(decompressor.IsDone() && decompressor.GetDecompressedSize() == segment->size, ResultInvalidNso());
             }
 
             /* Check hash if necessary. */
             if (check_hash) {
                 u8 hash[crypto::Sha256Generator::HashSize];
-                crypto::GenerateSha256Hash(hash, sizeof(hash), reinterpret_cast<void *>(map_base), segment->size);
+                sha.GetHash(hash, sizeof(hash));
 
                 R_UNLESS(std::memcmp(hash, file_hash, sizeof(hash)) == 0, ResultInvalidNso());
             }
@@ -558,6 +588,9 @@ namespace ams::ldr {
         Result LoadNsosIntoProcessMemory(const ProcessInfo *process_info, const NsoHeader *nso_headers, const bool *has_nso, const args::ArgumentInfo *arg_info) {
             const Handle process_handle = process_info->process_handle.Get();
 
+            /* Make sure the patches we apply to this process's NSOs reflect any changes made since the last process was created. */
+            RequestIpsPatchRevalidation();
+
             /* Load each NSO. */
             for (size_t i = 0; i < Nso_Count; i++) {
                 if (has_nso[i]) {
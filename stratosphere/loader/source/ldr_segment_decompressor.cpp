@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "ldr_segment_decompressor.hpp"
+
+namespace ams::ldr {
+
+    namespace {
+
+        constexpr size_t MinimumMatchSize = 4;
+
+        bool ReadExtendedSize(size_t *out, const u8 **cur, const u8 *end) {
+            /* A size of 0xF continues in the following bytes, until one isn't 0xFF. */
+            if (*out == 0xF) {
+                u8 extension;
+                do {
+                    if (*cur >= end) {
+                        return false;
+                    }
+                    extension = *((*cur)++);
+                    *out += extension;
+                } while (extension == 0xFF);
+            }
+            return true;
+        }
+
+    }
+
+    Result SegmentDecompressor::Decompress(const void *available_end) {
+        const u8 *available = static_cast<const u8 *>(available_end);
+        AMS_ASSERT(this->src_cur <= available && available <= this->src_end);
+
+        /* If a sequence would need input past the end of the block, the block is invalid. */
+        const bool is_complete = available == this->src_end;
+
+        while (this->src_cur < available) {
+            const u8 *cur = this->src_cur;
+            const u8 token = *(cur++);
+
+            /* Get the literals. */
+            size_t literal_size = token >> 4;
+            if (!ReadExtendedSize(std::addressof(literal_size), std::addressof(cur), available) || static_cast<size_t>(available - cur) < literal_size) {
+                R_UNLESS(!is_complete, ResultInvalidNso());
+                return ResultSuccess();
+            }
+            R_UNLESS(literal_size <= static_cast<size_t>(this->dst_end - this->dst_cur), ResultInvalidNso());
+
+            const u8 *literals = cur;
+            cur += literal_size;
+
+            /* The literals must not overwrite input we haven't consumed yet. */
+            R_UNLESS(this->dst_cur + literal_size <= cur, ResultInvalidNso());
+
+            /* The last sequence of a block has literals but no match. */
+            if (cur == this->src_end) {
+                std::memmove(this->dst_cur, literals, literal_size);
+                this->dst_cur += literal_size;
+                this->src_cur  = cur;
+                break;
+            }
+
+            /* Get the match. */
+            if (static_cast<size_t>(available - cur) < sizeof(u16)) {
+                R_UNLESS(!is_complete, ResultInvalidNso());
+                return ResultSuccess();
+            }
+            const size_t match_offset = static_cast<size_t>(cur[0]) | (static_cast<size_t>(cur[1]) << 8);
+            cur += sizeof(u16);
+
+            size_t match_size = token & 0xF;
+            if (!ReadExtendedSize(std::addressof(match_size), std::addressof(cur), available)) {
+                R_UNLESS(!is_complete, ResultInvalidNso());
+                return ResultSuccess();
+            }
+            match_size += MinimumMatchSize;
+
+            /* Validate the match. */
+            u8 *match_dst = this->dst_cur + literal_size;
+            R_UNLESS(match_offset != 0,                                                 ResultInvalidNso());
+            R_UNLESS(match_offset <= static_cast<size_t>(match_dst - this->dst_start),  ResultInvalidNso());
+            R_UNLESS(match_size <= static_cast<size_t>(this->dst_end - match_dst),      ResultInvalidNso());
+            R_UNLESS(match_dst + match_size <= cur,                                     ResultInvalidNso());
+
+            /* Copy the literals and the match. */
+            std::memmove(this->dst_cur, literals, literal_size);
+
+            const u8 *match_src = match_dst - match_offset;
+            if (match_offset >= match_size) {
+                std::memcpy(match_dst, match_src, match_size);
+            } else {
+                for (size_t i = 0; i < match_size; ++i) {
+                    match_dst[i] = match_src[i];
+                }
+            }
+
+            /* Advance. */
+            this->dst_cur = match_dst + match_size;
+            this->src_cur = cur;
+        }
+
+        return ResultSuccess();
+    }
+
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::ldr {
+
+    /* Decompresses an lz4 block as its input arrives, so that a segment can be read, decompressed and hashed a chunk at a time. */
+    /* Like util::DecompressLZ4, the input may sit at the end of the output buffer; output never overtakes the input consumed. */
+    class SegmentDecompressor {
+        NON_COPYABLE(SegmentDecompressor);
+        NON_MOVEABLE(SegmentDecompressor);
+        private:
+            u8 *dst_start;
+            u8 *dst_cur;
+            u8 *dst_end;
+            const u8 *src_cur;
+            const u8 *src_end;
+        public:
+            SegmentDecompressor(void *dst, size_t dst_size, const void *src, size_t src_size)
+                : dst_start(static_cast<u8 *>(dst)), dst_cur(static_cast<u8 *>(dst)), dst_end(static_cast<u8 *>(dst) + dst_size),
+                  src_cur(static_cast<const u8 *>(src)), src_end(static_cast<const u8 *>(src) + src_size)
+            {
+                /* ... */
+            }
+
+            /* Decompresses every sequence which lies entirely before available_end. */
+            Result Decompress(const void *available_end);
+
+            bool IsDone() const { return this->src_cur == this->src_end; }
+            size_t GetDecompressedSize() const { return static_cast<size_t>(this->dst_cur - this->dst_start); }
+    };
+
+}
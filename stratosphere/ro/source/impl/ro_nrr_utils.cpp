@@ -240,7 +240,7 @@ namespace ams::ro::impl {
 
         /* Hash the hash table, checking if the desired hash exists inside it. */
         size_t remaining_size = signed_area_size - pre_hash_table_size;
-        bool found_hash = false;
+        bool found_hash = desired_hash == nullptr;
         for (size_t i = 0; i < num_hashes; i++) {
             /* Get the current hash. */
             u8 cur_hash[crypto::Sha256Generator::HashSize];
@@ -250,7 +250,9 @@ namespace ams::ro::impl {
             sha256.Update(cur_hash, sizeof(cur_hash));
 
             /* Check if the current hash is our target. */
-            found_hash |= std::memcmp(cur_hash, desired_hash, sizeof(cur_hash)) == 0;
+            if (desired_hash != nullptr) {
+                found_hash |= std::memcmp(cur_hash, desired_hash, sizeof(cur_hash)) == 0;
+            }
 
             /* Advance our pointers. */
             hash_table     += sizeof(cur_hash);
@@ -29,6 +29,11 @@ namespace ams::ro::impl {
 
     }
 
+    /* Check for changed IPS patches before the next module is patched. */
+    void RequestIpsPatchRevalidation() {
+        ams::patcher::RequestPatchIndexRevalidation();
+    }
+
     /* Apply IPS patches. */
     void LocateAndApplyIpsPatchesToModule(const ModuleId *module_id, u8 *mapped_nro, size_t mapped_size) {
         ams::patcher::LocateAndApplyIpsPatchesToModule("sdmc", NroPatchesDirectory, NroPatchesProtectedSize, NroPatchesProtectedOffset, module_id, mapped_nro, mapped_size);
@@ -19,6 +19,9 @@
 
 namespace ams::ro::impl {
 
+    /* Check for changed IPS patches before the next module is patched. */
+    void RequestIpsPatchRevalidation();
+
     /* Apply IPS patches. */
     void LocateAndApplyIpsPatchesToModule(const ModuleId *module_id, u8 *mapped_nro, size_t mapped_size);
 
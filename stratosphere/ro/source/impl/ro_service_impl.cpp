@@ -70,8 +70,32 @@ namespace ams::ro::impl {
             u32 cached_num_hashes;
             u8  cached_signed_area[sizeof(NrrHeader) - NrrHeader::GetSignedAreaOffset()];
             Sha256Hash signed_area_hash;
+            const Sha256Hash *cached_hashes;
         };
 
+        /* Hash tables are copied into our own memory when their NRR is registered, and validated once, so that loads can search the copy. */
+        /* Tables that don't fit are validated against the mapped NRR on every load instead. */
+        constexpr size_t NrrHashCacheHeapSize = 0x8000;
+        alignas(os::MemoryPageSize) constinit u8 g_nrr_hash_cache_heap_buffer[NrrHashCacheHeapSize];
+        constinit lmem::HeapHandle g_nrr_hash_cache_heap_handle = nullptr;
+
+        Sha256Hash *AllocateNrrHashCache(size_t num_hashes) {
+            if (g_nrr_hash_cache_heap_handle == nullptr) {
+                g_nrr_hash_cache_heap_handle = lmem::CreateExpHeap(g_nrr_hash_cache_heap_buffer, sizeof(g_nrr_hash_cache_heap_buffer), lmem::CreateOption_None);
+            }
+
+            if (num_hashes == 0 || num_hashes > NrrHashCacheHeapSize / sizeof(Sha256Hash)) {
+                return nullptr;
+            }
+            return static_cast<Sha256Hash *>(lmem::AllocateFromExpHeap(g_nrr_hash_cache_heap_handle, num_hashes * sizeof(Sha256Hash)));
+        }
+
+        void FreeNrrHashCache(const Sha256Hash *hashes) {
+            if (hashes != nullptr) {
+                lmem::FreeToExpHeap(g_nrr_hash_cache_heap_handle, const_cast<Sha256Hash *>(hashes));
+            }
+        }
+
         struct ProcessContext {
             bool nro_in_use[MaxNroInfos];
             bool nrr_in_use[MaxNrrInfos];
@@ -170,6 +194,16 @@ namespace ams::ro::impl {
                         continue;
                     }
 
+                    /* If we have a validated copy of the hash table, just search it. */
+                    if (const Sha256Hash *cached_hashes = this->nrr_infos[i].cached_hashes; cached_hashes != nullptr) {
+                        const Sha256Hash *cached_hashes_end = cached_hashes + this->nrr_infos[i].cached_num_hashes;
+                        const Sha256Hash *cached_lower_bound = std::lower_bound(cached_hashes, cached_hashes_end, hash);
+                        if (cached_lower_bound != cached_hashes_end && *cached_lower_bound == hash) {
+                            return ResultSuccess();
+                        }
+                        continue;
+                    }
+
                     /* Get the mapped header, ensure that it has hashes. */
                     const NrrHeader *mapped_nrr_header = this->nrr_infos[i].mapped_header;
                     const size_t mapped_num_hashes = mapped_nrr_header->GetNumHashes();
@@ -325,6 +359,7 @@ namespace ams::ro::impl {
                 if (context->process_handle != INVALID_HANDLE) {
                     for (size_t i = 0; i < MaxNrrInfos; i++) {
                         if (context->nrr_in_use[i]) {
+                            FreeNrrHashCache(context->nrr_infos[i].cached_hashes);
                             UnmapNrr(context->process_handle, context->nrr_infos[i].mapped_header, context->nrr_infos[i].nrr_heap_address, context->nrr_infos[i].nrr_heap_size, context->nrr_infos[i].mapped_code_address);
                         }
                     }
@@ -398,6 +433,9 @@ namespace ams::ro::impl {
         R_UNLESS(GetContextByProcessId(process_id) == nullptr, ResultInvalidSession());
 
         *out_context_id = AllocateContext(process_handle.Move(), process_id);
+
+        /* Make sure the patches we apply to this process's NROs reflect any changes made since the last process registered. */
+        RequestIpsPatchRevalidation();
         return ResultSuccess();
     }
 
@@ -451,6 +489,29 @@ namespace ams::ro::impl {
         std::memcpy(nrr_info->cached_signed_area, header->GetSignedArea(), std::min(sizeof(nrr_info->cached_signed_area), header->GetHashesOffset() - header->GetSignedAreaOffset()));
         std::memcpy(std::addressof(nrr_info->signed_area_hash), std::addressof(signed_area_hash), sizeof(signed_area_hash));
 
+        /* Try to copy the hash table into our own memory. */
+        nrr_info->cached_hashes = nullptr;
+        {
+            /* The hash table must lie within the signed area, after the part of it that we cache. */
+            const size_t num_hashes          = nrr_info->cached_num_hashes;
+            const size_t hashes_offset       = nrr_info->cached_hashes_offset;
+            const size_t signed_area_offset  = NrrHeader::GetSignedAreaOffset();
+            const size_t signed_area_size    = nrr_info->cached_signed_area_size;
+            const size_t pre_hash_table_size = hashes_offset - signed_area_offset;
+            if (signed_area_offset <= hashes_offset && pre_hash_table_size <= sizeof(nrr_info->cached_signed_area) && pre_hash_table_size <= signed_area_size && num_hashes <= (signed_area_size - pre_hash_table_size) / sizeof(Sha256Hash)) {
+                if (Sha256Hash *cached_hashes = AllocateNrrHashCache(num_hashes); cached_hashes != nullptr) {
+                    std::memcpy(cached_hashes, header->GetHashes(), num_hashes * sizeof(Sha256Hash));
+
+                    /* Validate the copy, so that it can be trusted even if the mapped NRR changes later. */
+                    if (ValidateNrrHashTableEntry(nrr_info->cached_signed_area, nrr_info->cached_signed_area_size, hashes_offset, num_hashes, std::addressof(nrr_info->signed_area_hash), reinterpret_cast<const u8 *>(cached_hashes), nullptr)) {
+                        nrr_info->cached_hashes = cached_hashes;
+                    } else {
+                        FreeNrrHashCache(cached_hashes);
+                    }
+                }
+            }
+        }
+
         return ResultSuccess();
     }
 
@@ -466,6 +527,9 @@ namespace ams::ro::impl {
         NrrInfo *nrr_info = nullptr;
         R_TRY(context->GetNrrInfoByAddress(&nrr_info, nrr_address));
 
+        /* Free our copy of the hash table. */
+        FreeNrrHashCache(nrr_info->cached_hashes);
+
         /* Unmap. */
         const NrrInfo nrr_backup = *nrr_info;
         {
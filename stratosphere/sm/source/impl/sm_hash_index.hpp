@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::sm::impl {
+
+    constexpr ALWAYS_INLINE u64 GetIndexKey(os::ProcessId process_id) {
+        return static_cast<u64>(process_id);
+    }
+
+    ALWAYS_INLINE u64 GetIndexKey(ServiceName service) {
+        static_assert(sizeof(service) == sizeof(u64));
+
+        u64 key;
+        std::memcpy(std::addressof(key), std::addressof(service), sizeof(key));
+        return key;
+    }
+
+    /* Maps 64-bit keys to indices into a fixed-size array, and tracks which indices are free. */
+    template<size_t Capacity>
+    class HashIndex {
+        NON_COPYABLE(HashIndex);
+        NON_MOVEABLE(HashIndex);
+        private:
+            /* Keep the table at most half full, and a power of two in size so that probing can wrap with a mask. */
+            static constexpr size_t BucketCount = util::CeilingPowerOfTwo<size_t>(2 * Capacity);
+            static_assert(util::IsPowerOfTwo(BucketCount));
+
+            static constexpr size_t BucketBits = BITSIZEOF(u64) - util::CountLeadingZeros<u64>(BucketCount - 1);
+            static constexpr u16 EmptyBucket = std::numeric_limits<u16>::max();
+            static_assert(Capacity < EmptyBucket);
+
+            static constexpr size_t FreeWordCount = util::DivideUp(Capacity, BITSIZEOF(u64));
+
+            struct Bucket {
+                u64 key;
+                u16 index;
+            };
+        private:
+            Bucket buckets[BucketCount];
+            u64 free_words[FreeWordCount];
+        private:
+            static constexpr ALWAYS_INLINE size_t GetHomeBucket(u64 key) {
+                /* Fibonacci hashing, taking the high bits of the product. */
+                return static_cast<size_t>((key * UINT64_C(0x9E3779B97F4A7C15)) >> (BITSIZEOF(u64) - BucketBits));
+            }
+
+            static constexpr ALWAYS_INLINE size_t GetNextBucket(size_t bucket) {
+                return (bucket + 1) & (BucketCount - 1);
+            }
+
+            constexpr ALWAYS_INLINE void SetFree(size_t index, bool is_free) {
+                const u64 mask = UINT64_C(1) << (index % BITSIZEOF(u64));
+                if (is_free) {
+                    this->free_words[index / BITSIZEOF(u64)] |= mask;
+                } else {
+                    this->free_words[index / BITSIZEOF(u64)] &= ~mask;
+                }
+            }
+        public:
+            constexpr HashIndex() : buckets(), free_words() {
+                for (auto &bucket : this->buckets) {
+                    bucket.key   = 0;
+                    bucket.index = EmptyBucket;
+                }
+                for (size_t i = 0; i < Capacity; i++) {
+                    this->SetFree(i, true);
+                }
+            }
+
+            s32 Find(u64 key) const {
+                for (size_t bucket = GetHomeBucket(key); this->buckets[bucket].index != EmptyBucket; bucket = GetNextBucket(bucket)) {
+                    if (this->buckets[bucket].key == key) {
+                        return this->buckets[bucket].index;
+                    }
+                }
+                return -1;
+            }
+
+            s32 FindFree() const {
+                /* Prefer the lowest free index, as a linear scan of the array would. */
+                for (size_t i = 0; i < FreeWordCount; i++) {
+                    if (this->free_words[i] != 0) {
+                        return static_cast<s32>(i * BITSIZEOF(u64) + __builtin_ctzll(this->free_words[i]));
+                    }
+                }
+                return -1;
+            }
+
+            void Insert(u64 key, size_t index) {
+                AMS_ABORT_UNLESS(index < Capacity);
+                AMS_ABORT_UNLESS(this->Find(key) < 0);
+
+                size_t bucket = GetHomeBucket(key);
+                while (this->buckets[bucket].index != EmptyBucket) {
+                    bucket = GetNextBucket(bucket);
+                }
+
+                this->buckets[bucket].key   = key;
+                this->buckets[bucket].index = static_cast<u16>(index);
+                this->SetFree(index, false);
+            }
+
+            void Remove(u64 key) {
+                /* Find the bucket holding the key. */
+                size_t bucket = GetHomeBucket(key);
+                while (true) {
+                    AMS_ABORT_UNLESS(this->buckets[bucket].index != EmptyBucket);
+                    if (this->buckets[bucket].key == key) {
+                        break;
+                    }
+                    bucket = GetNextBucket(bucket);
+                }
+
+                this->SetFree(this->buckets[bucket].index, true);
+                this->buckets[bucket].index = EmptyBucket;
+
+                /* Shift back any following entries that would no longer be reachable from their home bucket. */
+                for (size_t next = GetNextBucket(bucket); this->buckets[next].index != EmptyBucket; next = GetNextBucket(next)) {
+                    const size_t home = GetHomeBucket(this->buckets[next].key);
+                    const size_t dist_to_hole = (bucket - home) & (BucketCount - 1);
+                    const size_t dist_to_next = (next - home) & (BucketCount - 1);
+                    if (dist_to_hole < dist_to_next) {
+                        this->buckets[bucket] = this->buckets[next];
+                        this->buckets[next].index = EmptyBucket;
+                        bucket = next;
+                    }
+                }
+            }
+    };
+
+}
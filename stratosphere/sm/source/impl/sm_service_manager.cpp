@@ -16,6 +16,7 @@
 #include <stratosphere.hpp>
 #include "sm_service_manager.hpp"
 #include "sm_wait_list.hpp"
+#include "sm_hash_index.hpp"
 
 namespace ams::sm::impl {
 
@@ -175,18 +176,30 @@ namespace ams::sm::impl {
         InitialProcessIdLimits g_initial_process_id_limits;
         bool g_ended_initial_defers;
 
+        /* Hash indices, kept in sync with the lists above. */
+        HashIndex<ProcessCountMax> g_process_index;
+        HashIndex<ServiceCountMax> g_service_index;
+        HashIndex<FutureMitmCountMax> g_future_mitm_index;
+
         /* Helper functions for interacting with processes/services. */
         ProcessInfo *GetProcessInfo(os::ProcessId process_id) {
-            for (size_t i = 0; i < ProcessCountMax; i++) {
-                if (g_process_list[i].process_id == process_id) {
-                    return &g_process_list[i];
-                }
-            }
-            return nullptr;
+            const s32 index = g_process_index.Find(GetIndexKey(process_id));
+            return index >= 0 ? &g_process_list[index] : nullptr;
         }
 
         ProcessInfo *GetFreeProcessInfo() {
-            return GetProcessInfo(os::InvalidProcessId);
+            const s32 index = g_process_index.FindFree();
+            return index >= 0 ? &g_process_list[index] : nullptr;
+        }
+
+        void SetProcessInfoId(ProcessInfo *process_info, os::ProcessId process_id) {
+            process_info->process_id = process_id;
+            g_process_index.Insert(GetIndexKey(process_id), process_info - g_process_list);
+        }
+
+        void FreeProcessInfo(ProcessInfo *process_info) {
+            g_process_index.Remove(GetIndexKey(process_info->process_id));
+            process_info->Free();
         }
 
         bool HasProcessInfo(os::ProcessId process_id) {
@@ -202,16 +215,23 @@ namespace ams::sm::impl {
         }
 
         ServiceInfo *GetServiceInfo(ServiceName service_name) {
-            for (size_t i = 0; i < ServiceCountMax; i++) {
-                if (g_service_list[i].name == service_name) {
-                    return &g_service_list[i];
-                }
-            }
-            return nullptr;
+            const s32 index = g_service_index.Find(GetIndexKey(service_name));
+            return index >= 0 ? &g_service_list[index] : nullptr;
         }
 
         ServiceInfo *GetFreeServiceInfo() {
-            return GetServiceInfo(InvalidServiceName);
+            const s32 index = g_service_index.FindFree();
+            return index >= 0 ? &g_service_list[index] : nullptr;
+        }
+
+        void SetServiceInfoName(ServiceInfo *service_info, ServiceName service) {
+            service_info->name = service;
+            g_service_index.Insert(GetIndexKey(service), service_info - g_service_list);
+        }
+
+        void FreeServiceInfo(ServiceInfo *service_info) {
+            g_service_index.Remove(GetIndexKey(service_info->name));
+            service_info->Free();
         }
 
         bool HasServiceInfo(ServiceName service) {
@@ -247,29 +267,22 @@ namespace ams::sm::impl {
         }
 
         Result AddFutureMitmDeclaration(ServiceName service) {
-            for (size_t i = 0; i < FutureMitmCountMax; i++) {
-                if (g_future_mitm_list[i] == InvalidServiceName) {
-                    g_future_mitm_list[i] = service;
-                    return ResultSuccess();
-                }
-            }
-            return sm::ResultOutOfServices();
+            const s32 index = g_future_mitm_index.FindFree();
+            R_UNLESS(index >= 0, sm::ResultOutOfServices());
+
+            g_future_mitm_list[index] = service;
+            g_future_mitm_index.Insert(GetIndexKey(service), index);
+            return ResultSuccess();
         }
 
         bool HasFutureMitmDeclaration(ServiceName service) {
-            for (size_t i = 0; i < FutureMitmCountMax; i++) {
-                if (g_future_mitm_list[i] == service) {
-                    return true;
-                }
-            }
-            return false;
+            return g_future_mitm_index.Find(GetIndexKey(service)) >= 0;
         }
 
         void ClearFutureMitmDeclaration(ServiceName service) {
-            for (size_t i = 0; i < FutureMitmCountMax; i++) {
-                if (g_future_mitm_list[i] == service) {
-                    g_future_mitm_list[i] = InvalidServiceName;
-                }
+            if (const s32 index = g_future_mitm_index.Find(GetIndexKey(service)); index >= 0) {
+                g_future_mitm_list[index] = InvalidServiceName;
+                g_future_mitm_index.Remove(GetIndexKey(service));
             }
 
             /* This might undefer some requests. */
@@ -412,7 +425,7 @@ namespace ams::sm::impl {
             R_TRY(svcCreatePort(out, free_service->port_h.GetPointerAndClear(), max_sessions, is_light, free_service->name.name));
 
             /* Save info. */
-            free_service->name = service;
+            SetServiceInfoName(free_service, service);
             free_service->owner_process_id = process_id;
             free_service->max_sessions = max_sessions;
             free_service->is_light = is_light;
@@ -435,7 +448,7 @@ namespace ams::sm::impl {
         /* Unregister all services a client hosts, on attached-client-close. */
         for (size_t i = 0; i < ServiceCountMax; i++) {
             if (g_service_list[i].name != InvalidServiceName && g_service_list[i].owner_process_id == process_id) {
-                g_service_list[i].Free();
+                FreeServiceInfo(&g_service_list[i]);
             }
         }
     }
@@ -445,6 +458,9 @@ namespace ams::sm::impl {
         /* Check that access control will fit in the ServiceInfo. */
         R_UNLESS(aci_sac_size <= AccessControlSizeMax, sm::ResultTooLargeAccessControl());
 
+        /* Don't try to register something already registered. */
+        R_UNLESS(!HasProcessInfo(process_id), sm::ResultAlreadyRegistered());
+
         /* Get free process. */
         ProcessInfo *proc = GetFreeProcessInfo();
         R_UNLESS(proc != nullptr, sm::ResultOutOfProcesses());
@@ -454,7 +470,7 @@ namespace ams::sm::impl {
         R_TRY(ValidateAccessControl(AccessControlEntry(acid_sac, acid_sac_size), AccessControlEntry(aci_sac, aci_sac_size)));
 
         /* Save info. */
-        proc->process_id = process_id;
+        SetProcessInfoId(proc, process_id);
         proc->program_id = program_id;
         proc->override_status = override_status;
         proc->access_control_size = aci_sac_size;
@@ -467,7 +483,7 @@ namespace ams::sm::impl {
         ProcessInfo *proc = GetProcessInfo(process_id);
         R_UNLESS(proc != nullptr, sm::ResultInvalidClient());
 
-        proc->Free();
+        FreeProcessInfo(proc);
         return ResultSuccess();
     }
 
@@ -560,7 +576,7 @@ namespace ams::sm::impl {
         R_UNLESS(service_info->owner_process_id == process_id, sm::ResultNotAllowed());
 
         /* Unregister the service. */
-        service_info->Free();
+        FreeServiceInfo(service_info);
         return ResultSuccess();
     }
 
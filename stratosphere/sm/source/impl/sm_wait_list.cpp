@@ -15,40 +15,81 @@
  */
 #include <stratosphere.hpp>
 #include "sm_wait_list.hpp"
+#include "sm_hash_index.hpp"
 
 namespace ams::sm::impl {
 
     namespace {
 
-        static constexpr size_t DeferredSessionCountMax = 0x40;
+        /* A session can only be deferred once at a time, and the server manager can't hold more sessions than this. */
+        static constexpr size_t DeferredSessionCountMax = ServerSessionCountMax;
 
-        struct WaitListEntry {
+        struct WaitListEntry : public util::IntrusiveListBaseNode<WaitListEntry> {
             sm::ServiceName service;
             os::WaitableHolderType *session;
         };
 
-        constinit WaitListEntry g_entries[DeferredSessionCountMax];
+        using WaitList = util::IntrusiveListBaseTraits<WaitListEntry>::ListType;
+
+        WaitListEntry g_entries[DeferredSessionCountMax];
+        WaitList g_free_entries;
+        constinit size_t g_num_used_entries = 0;
+
+        /* Deferred sessions are queued per service, so resuming a service only touches its own waiters. */
+        WaitList g_wait_lists[DeferredSessionCountMax];
+        HashIndex<DeferredSessionCountMax> g_wait_list_index;
+
         constinit WaitListEntry *g_processing_entry = nullptr;
         constinit ServiceName g_triggered_service = InvalidServiceName;
 
-        WaitListEntry *Find(ServiceName service) {
-            for (auto &entry : g_entries) {
-                if (entry.service == service) {
-                    return std::addressof(entry);
-                }
+        WaitListEntry *AllocateEntry() {
+            /* Prefer recycling a previously used entry. */
+            if (!g_free_entries.empty()) {
+                auto *entry = std::addressof(g_free_entries.front());
+                g_free_entries.pop_front();
+                return entry;
+            }
+
+            /* Otherwise, take a fresh one. */
+            if (g_num_used_entries < util::size(g_entries)) {
+                return std::addressof(g_entries[g_num_used_entries++]);
             }
 
             return nullptr;
         }
 
+        void FreeEntry(WaitListEntry *entry) {
+            entry->service = InvalidServiceName;
+            entry->session = nullptr;
+            g_free_entries.push_back(*entry);
+        }
+
+        WaitList *FindWaitList(ServiceName service) {
+            const s32 index = g_wait_list_index.Find(GetIndexKey(service));
+            return index >= 0 ? std::addressof(g_wait_lists[index]) : nullptr;
+        }
+
+        WaitList *FindOrCreateWaitList(ServiceName service) {
+            if (auto *list = FindWaitList(service); list != nullptr) {
+                return list;
+            }
+
+            /* There are never more lists than entries, so this can't fail. */
+            const s32 index = g_wait_list_index.FindFree();
+            AMS_ABORT_UNLESS(index >= 0);
+
+            g_wait_list_index.Insert(GetIndexKey(service), index);
+            return std::addressof(g_wait_lists[index]);
+        }
+
     }
 
     Result StartRegisterRetry(ServiceName service) {
         /* Check that we're not already processing a retry. */
         AMS_ABORT_UNLESS(g_processing_entry == nullptr);
 
-        /* Find a free entry. */
-        auto *entry = Find(InvalidServiceName);
+        /* Get a free entry. */
+        auto *entry = AllocateEntry();
         R_UNLESS(entry != nullptr, sm::ResultOutOfProcesses());
 
         /* Initialize the entry. */
@@ -67,6 +108,9 @@ namespace ams::sm::impl {
 
         /* Process the session. */
         g_processing_entry->session = session_holder;
+
+        /* Queue the entry behind any other sessions waiting on its service. */
+        FindOrCreateWaitList(g_processing_entry->service)->push_back(*g_processing_entry);
         g_processing_entry = nullptr;
     }
 
@@ -79,25 +123,27 @@ namespace ams::sm::impl {
     }
 
     void TestAndResume(ResumeFunction resume_function) {
-        /* If we don't have a triggered service, there's nothing to do. */
-        if (g_triggered_service == InvalidServiceName) {
-            return;
-        }
-
-        /* Get and clear the triggered service. */
-        const auto resumed_service = g_triggered_service;
-        g_triggered_service = InvalidServiceName;
+        /* Process triggered services until there are none left. */
+        while (g_triggered_service != InvalidServiceName) {
+            /* Get and clear the triggered service. */
+            const auto resumed_service = g_triggered_service;
+            g_triggered_service = InvalidServiceName;
+
+            /* Get the service's wait list, if anything is waiting on it. */
+            auto *list = FindWaitList(resumed_service);
+            if (list == nullptr) {
+                continue;
+            }
 
-        /* Process all entries. */
-        for (size_t i = 0; i < util::size(g_entries); /* ... */) {
-            auto &entry = g_entries[i];
-            if (entry.service == resumed_service) {
+            /* Process the entries that were waiting when we started; any that defer again are re-queued at the back. */
+            for (size_t remaining = list->size(); remaining > 0; --remaining) {
                 /* Get the entry's session. */
-                auto * const session = entry.session;
+                auto *entry = std::addressof(list->front());
+                auto * const session = entry->session;
 
-                /* Clear the entry. */
-                entry.service = InvalidServiceName;
-                entry.session = nullptr;
+                /* Free the entry. */
+                list->pop_front();
+                FreeEntry(entry);
 
                 /* Resume the request. */
                 R_TRY_CATCH(resume_function(session)) {
@@ -106,18 +152,17 @@ namespace ams::sm::impl {
                     }
                 } R_END_TRY_CATCH_WITH_ABORT_UNLESS;
 
-                /* Handle nested resumes. */
+                /* Handle nested resumes, by processing the whole list again. */
                 if (g_triggered_service != InvalidServiceName) {
                     AMS_ABORT_UNLESS(g_triggered_service == resumed_service);
-
-                    g_triggered_service = InvalidServiceName;
-                    i = 0;
-                    continue;
+                    break;
                 }
             }
 
-            /* Advance. */
-            ++i;
+            /* If nothing is waiting on the service any more, release its list. */
+            if (list->empty()) {
+                g_wait_list_index.Remove(GetIndexKey(resumed_service));
+            }
         }
     }
 
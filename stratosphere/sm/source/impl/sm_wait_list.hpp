@@ -18,6 +18,10 @@
 
 namespace ams::sm::impl {
 
+    /* sm's server manager serves one port per interface, and as many sessions as it can wait on alongside them. */
+    constexpr size_t ServerPortCount       = 3;
+    constexpr size_t ServerSessionCountMax = sf::hipc::ServerSessionCountMax - ServerPortCount;
+
     using ResumeFunction = Result (*)(os::WaitableHolderType *session_holder);
 
     Result StartRegisterRetry(ServiceName service);
@@ -86,8 +86,9 @@ namespace {
         PortIndex_DebugMonitor,
         PortIndex_Count,
     };
+    static_assert(PortIndex_Count == sm::impl::ServerPortCount);
 
-    class ServerManager final : public sf::hipc::ServerManager<PortIndex_Count> {
+    class ServerManager final : public sf::hipc::ServerManager<PortIndex_Count, sf::hipc::DefaultServerManagerOptions, sm::impl::ServerSessionCountMax> {
         private:
             virtual ams::Result OnNeedsToAccept(int port_index, Server *server) override;
     };